@@ -15,19 +15,28 @@
 #include <iostream>
 #include <algorithm>
 #include <cstring>
+#include <cstdio>
 #include <set>
+#include <atomic>
+#include <thread>
+#include <charconv>
 
 #include "parsing.hpp"
+#include "LuaFFIGenerator.hpp"
 
-static std::set<std::string> made_types;
-static std::string game_state;
+// state read by the helpers during one generation; each generation owns one and passes it down, so that
+// separate schemas can be generated concurrently within one process
+struct generation_context {
+	std::set<std::string> made_types;
+	std::string game_state;
+};
 
 enum class meta_information {
 	id, value, value_pointer, empty
 };
 
 enum class array_access {
-	function_call, get_call, set_call, resize_call, size_call
+	function_call, get_call, set_call, resize_call, size_call, member_call
 };
 
 enum class lua_type_match {
@@ -52,17 +61,10 @@ struct function_call_information {
 	std::string accessed_property;
 	std::vector<arg_information> in;
 	arg_information out;
+	std::string before_call = "";
+	std::string after_call = "";
 };
 
-void error_to_file(std::string const& file_name) {
-	std::fstream fileout;
-	fileout.open(file_name, std::ios::out);
-	if(fileout.is_open()) {
-		fileout << "";
-		fileout.close();
-	}
-}
-
 relationship_object_def const* better_primary_key(relationship_object_def const* oldr, relationship_object_def const* newr) {
 	if(oldr == nullptr) {
 		return newr;
@@ -135,10 +137,10 @@ std::string convert_lua_enum_to_type(lua_type_match v) {
 
 
 
-std::string convert_to_id(std::string in) {
-	if (made_types.count(in) > 0) {
+std::string convert_to_id(generation_context const& ctx, std::string in) {
+	if (ctx.made_types.count(in) > 0) {
 		return in;
-	} else if (made_types.count(in + "_id") > 0) {
+	} else if (ctx.made_types.count(in + "_id") > 0) {
 		return in + "_id";
 	}
 	return in;
@@ -233,8 +235,8 @@ std::string convert_raw_to_id_from_id (file_def& file, std::string id_type_name,
 	return file.namspace + "::" + id_type_name + "{" + file.namspace + "::" + id_type_name + "::value_base_t(" + raw_id + ")}";
 }
 
-std::string convert_raw_to_index (file_def& file, std::string index_type, std::string raw_index) {
-	auto norm_index_type = normalize_type(index_type, made_types);
+std::string convert_raw_to_index (generation_context const& ctx, file_def& file, std::string index_type, std::string raw_index) {
+	auto norm_index_type = normalize_type(index_type, ctx.made_types);
 	std::string index_access_string;
 	if(norm_index_type.normalized == lua_type_match::handle_to_integer) {
 		index_access_string = convert_raw_to_id_from_id(file, index_type, raw_index);
@@ -252,9 +254,9 @@ std::string declare_id_from_raw_id (std::string indent, file_def& file, std::str
 	return indent + "auto " + id + " = " + convert_raw_to_id_from_id(file, object_name, raw_id) + ";\n";
 }
 
-std::string declare_index_from_raw (std::string indent, file_def& file, std::string index_type, std::string raw_index, std::string index) {
+std::string declare_index_from_raw (generation_context const& ctx, std::string indent, file_def& file, std::string index_type, std::string raw_index, std::string index) {
 
-	return indent + "auto " + index + " = " + convert_raw_to_index(file, index_type, raw_index) + ";\n";
+	return indent + "auto " + index + " = " + convert_raw_to_index(ctx, file, index_type, raw_index) + ";\n";
 }
 
 std::string access_property_name(
@@ -276,23 +278,32 @@ std::string access_property_name(
 }
 
 std::string access_core_property_name(
-	std::string object_name, std::string property
+	generation_context const& ctx, std::string object_name, std::string property
 ) {
-	return game_state + object_name + "_" + property;
+	return ctx.game_state + object_name + "_" + property;
+}
+
+// the data container itself, as opposed to the member access prefix held by ctx.game_state
+std::string container_reference(generation_context const& ctx) {
+	if(ctx.game_state.size() >= 2 && ctx.game_state.compare(ctx.game_state.size() - 2, 2, "->") == 0)
+		return "(*" + ctx.game_state.substr(0, ctx.game_state.size() - 2) + ")";
+	if(ctx.game_state.size() >= 1 && ctx.game_state.back() == '.')
+		return ctx.game_state.substr(0, ctx.game_state.size() - 1);
+	return ctx.game_state;
 }
 
 
-arg_information normalize_argument(std::string name, bool is_bool, std::string& declared_type) {
-	if (made_types.count(declared_type) + made_types.count(declared_type + "_id") > 0) {
+arg_information normalize_argument(generation_context const& ctx, std::string name, bool is_bool, std::string& declared_type) {
+	if (ctx.made_types.count(declared_type) + ctx.made_types.count(declared_type + "_id") > 0) {
 		return {
 			meta_information::id,
-			normalize_type(declared_type, made_types),
+			normalize_type(declared_type, ctx.made_types),
 			name
 		};
 	} else {
 		arg_information arg {
 			meta_information::value,
-			normalize_type(declared_type, made_types),
+			normalize_type(declared_type, ctx.made_types),
 			name
 		};
 		if (is_bool) {
@@ -381,7 +392,7 @@ std::string generate_head(function_call_information desc) {
 	return result;
 }
 
-auto generate_body(file_def& file, function_call_information desc) {
+auto generate_body(generation_context const& ctx, file_def& file, function_call_information desc) {
 	std::string result = "";
 
 	result += "{\n";
@@ -410,11 +421,18 @@ auto generate_body(file_def& file, function_call_information desc) {
 		}
 	}
 
+	result += desc.before_call;
 	result += "\t";
-	if (desc.access_type == array_access::function_call) {
-		std::string call = access_core_property_name(desc.accessed_object, desc.accessed_property);
+	if (desc.access_type == array_access::function_call || desc.access_type == array_access::member_call) {
+		std::string call = access_core_property_name(ctx, desc.accessed_object, desc.accessed_property);
 		std::string args = "";
-		for (size_t i = 0; i < desc.in.size(); i++) {
+		size_t first_arg = 0;
+		if (desc.access_type == array_access::member_call) {
+			// member functions are reached through the fat handle of the first argument
+			call = file.namspace + "::fatten(" + container_reference(ctx) + ", " + container_arg_string(desc.in[0], 0) + ")." + desc.accessed_property;
+			first_arg = 1;
+		}
+		for (size_t i = first_arg; i < desc.in.size(); i++) {
 			args += container_arg_string(desc.in[i], i);
 			if (i + 1 < desc.in.size()) {
 				args += ", ";
@@ -446,7 +464,7 @@ auto generate_body(file_def& file, function_call_information desc) {
 		}
 	} else if (desc.access_type == array_access::set_call) {
 		assert(desc.in.size() == 3);
-		result += game_state + desc.accessed_object + "_get_" + desc.accessed_property;
+		result += ctx.game_state + desc.accessed_object + "_get_" + desc.accessed_property;
 		result += "(";
 		result += container_arg_string(desc.in[0], 0);
 		result += ")";
@@ -458,7 +476,7 @@ auto generate_body(file_def& file, function_call_information desc) {
 	} else if (desc.access_type == array_access::get_call) {
 		assert(desc.in.size() == 2);
 		std::string access_string = "";
-		access_string += game_state + desc.accessed_object + "_get_" + desc.accessed_property;
+		access_string += ctx.game_state + desc.accessed_object + "_get_" + desc.accessed_property;
 		access_string += "(";
 		access_string += container_arg_string(desc.in[0], 0);
 		access_string += ").at(";
@@ -489,7 +507,7 @@ auto generate_body(file_def& file, function_call_information desc) {
 		assert(desc.in.size() == 2);
 		assert(desc.out.meta_type == meta_information::empty);
 		std::string access_string = "";
-		access_string += game_state + desc.accessed_object + "_get_" + desc.accessed_property;
+		access_string += ctx.game_state + desc.accessed_object + "_get_" + desc.accessed_property;
 		access_string += "(";
 		access_string += container_arg_string(desc.in[0], 0);
 		access_string += ").resize(";
@@ -501,12 +519,13 @@ auto generate_body(file_def& file, function_call_information desc) {
 		assert(desc.in.size() == 1);
 		assert(desc.out.meta_type == meta_information::value);
 		std::string access_string = "";
-		access_string += game_state + desc.accessed_object + "_get_" + desc.accessed_property;
+		access_string += ctx.game_state + desc.accessed_object + "_get_" + desc.accessed_property;
 		access_string += "(";
 		access_string += container_arg_string(desc.in[0], 0);
 		access_string += ").size()";
 		result += "return (" + access_string + ");\n";
 	}
+	result += desc.after_call;
 
 	result += "}\n";
 
@@ -585,28 +604,2037 @@ std::string to_luatype(
 	return flat_name;
 }
 
+std::string trim(std::string const& in) {
+	auto first = in.find_first_not_of(" \t\r\n");
+	if(first == std::string::npos)
+		return "";
+	auto last = in.find_last_not_of(" \t\r\n");
+	return in.substr(first, last - first + 1);
+}
 
-int main(int argc, char *argv[]) {
-	if (argc < 5) {
-		printf("[1]: PROJECT NAME, [2] DATA CONTAINER VARIABLE, [3]: DCON DEFINITION FILE, [4]: CPP OUTPUT FILE, [5]: HPP OUTPUT FILE, [6]: LUA OUTPUT FOLDER");
-		return 1;
+// splits a member function signature into its return type and parameter types;
+// fails for anything which is not passed by value (references, pointers, templates, arrays)
+bool parse_member_signature(file_def const& file, member_function_spec const& fn, std::string& return_type, std::vector<std::string>& parameter_types) {
+	auto const& sig = fn.signature;
+	if(sig.find_first_of("&*<[") != std::string::npos)
+		return false;
+	auto open = sig.find('(');
+	auto close = sig.rfind(')');
+	if(open == std::string::npos || close == std::string::npos || close < open)
+		return false;
+
+	auto unqualify = [&](std::string t) {
+		if(t.compare(0, 6, "const ") == 0)
+			t = trim(t.substr(6));
+		auto const ns = file.namspace + "::";
+		if(t.compare(0, ns.size(), ns) == 0)
+			t = t.substr(ns.size());
+		return t;
+	};
+
+	auto head = trim(sig.substr(0, open));
+	if(head.size() <= fn.name.size() || head.compare(head.size() - fn.name.size(), fn.name.size(), fn.name) != 0)
+		return false;
+	return_type = unqualify(trim(head.substr(0, head.size() - fn.name.size())));
+
+	parameter_types.clear();
+	auto params = trim(sig.substr(open + 1, close - open - 1));
+	if(params.empty() || params == "void")
+		return fn.parameter_names.empty();
+	size_t start = 0;
+	while(start <= params.size()) {
+		auto comma = params.find(',', start);
+		if(comma == std::string::npos)
+			comma = params.size();
+		auto param = trim(params.substr(start, comma - start));
+		if(parameter_types.size() >= fn.parameter_names.size())
+			return false;
+		auto const& pname = fn.parameter_names[parameter_types.size()];
+		if(param.size() <= pname.size() || param.compare(param.size() - pname.size(), pname.size(), pname) != 0)
+			return false;
+		parameter_types.push_back(unqualify(trim(param.substr(0, param.size() - pname.size()))));
+		start = comma + 1;
 	}
+	return parameter_types.size() == fn.parameter_names.size();
+}
 
-	const std::string project_name = argv[1];
-	const std::string project_prefix = project_name + "_";
+// properties tagged lua_index which can be keyed by an integer: handles, bitfields and integral numbers
+std::vector<property_def const*> indexed_properties(generation_context const& ctx, relationship_object_def const& ob) {
+	std::vector<property_def const*> result;
+	if(ob.is_relationship)
+		return result;
+	for(auto& p : ob.properties) {
+		if(p.is_derived || std::find(p.property_tags.begin(), p.property_tags.end(), "lua_index") == p.property_tags.end())
+			continue;
+		if(p.type == property_type::bitfield) {
+			result.push_back(&p);
+		} else if(p.type == property_type::vectorizable || p.type == property_type::other) {
+			auto t = normalize_type(p.data_type, ctx.made_types);
+			if(t.normalized == lua_type_match::handle_to_integer
+				|| (t.normalized == lua_type_match::fat_float && t.c_type != "float" && t.c_type != "double")) {
+				result.push_back(&p);
+			}
+		}
+	}
+	return result;
+}
+
+std::string index_name(std::string const& project_prefix, relationship_object_def const& ob, property_def const& p) {
+	return project_prefix + ob.name + "_" + p.name + "_index";
+}
+
+// value -> ids table of a property, kept up to date by the generated bindings;
+// every id also records its slot within its bucket so that it can be removed in constant time.
+// Calls that may write the column behind the index's back only mark it dirty, and it is rebuilt by the
+// next lookup; it starts dirty so that rows which existed before the first lookup are indexed too
+std::string make_property_index(generation_context const& ctx, file_def& file, std::string const& project_prefix, relationship_object_def const& ob, property_def const& p, std::string& header_output, std::string& lua_cdef, std::string& lua_cdef_wrapper, std::string const& lua_namespace) {
+	std::string output;
+	auto const index = index_name(project_prefix, ob, p);
+	auto const id = convert_raw_to_id(file, ob.name, "id");
+	auto const is_handle = p.type != property_type::bitfield && normalize_type(p.data_type, ctx.made_types).normalized == lua_type_match::handle_to_integer;
+	auto const api_type = p.type == property_type::bitfield ? std::string("bool") : is_handle ? std::string("int32_t") : p.data_type;
+
+	output += "std::unordered_map<int64_t, std::vector<int32_t>> " + index;
+	output += ";\n";
+	output += "std::vector<int32_t> " + index + "_slot;\n";
+	output += "bool " + index + "_dirty = true;\n";
+
+	output += "int64_t " + index + "_key(int32_t id) { \n";
+	if(is_handle) {
+		output += "\treturn int64_t(" + ctx.game_state + ob.name + "_get_" + p.name + "(" + id + ").index());\n";
+	} else {
+		output += "\treturn int64_t(" + ctx.game_state + ob.name + "_get_" + p.name + "(" + id + "));\n";
+	}
+	output += "}\n";
+
+	output += "void " + index + "_insert(int32_t id) { \n";
+	output += "\tif(" + index + "_dirty)\n";
+	output += "\t\treturn;\n";
+	output += "\tif(" + index + "_slot.size() <= size_t(id))\n";
+	output += "\t\t" + index + "_slot.resize(size_t(id) + 1, -1);\n";
+	output += "\tauto& ids = " + index + "[" + index + "_key(id)];\n";
+	output += "\t" + index + "_slot[id] = int32_t(ids.size());\n";
+	output += "\tids.push_back(id);\n";
+	output += "}\n";
+
+	output += "void " + index + "_remove(int32_t id) { \n";
+	output += "\tif(" + index + "_dirty || size_t(id) >= " + index + "_slot.size() || " + index + "_slot[id] < 0)\n";
+	output += "\t\treturn;\n";
+	output += "\tauto it = " + index + ".find(" + index + "_key(id));\n";
+	output += "\tif(it == " + index + ".end())\n";
+	output += "\t\treturn;\n";
+	output += "\tauto& ids = it->second;\n";
+	output += "\tauto moved = ids.back();\n";
+	output += "\tids[" + index + "_slot[id]] = moved;\n";
+	output += "\t" + index + "_slot[moved] = " + index + "_slot[id];\n";
+	output += "\tids.pop_back();\n";
+	output += "\t" + index + "_slot[id] = -1;\n";
+	output += "\tif(ids.empty())\n";
+	output += "\t\t" + index + ".erase(it);\n";
+	output += "}\n";
+
+	auto const rebuild = project_prefix + ob.name + "_rebuild_" + p.name + "_index";
+	header_output += "DCON_LUADLL_API void " + rebuild + "(); \n";
+	output += "void " + rebuild + "() { \n";
+	output += "\tuint32_t const size = " + ctx.game_state + ob.name + "_size();\n";
+	output += "\t" + index + ".clear();\n";
+	output += "\t" + index + "_slot.assign(size, -1);\n";
+	output += "\t" + index + "_dirty = false;\n";
+	output += "\tfor(uint32_t i = 0; i < size; ++i) {\n";
+	output += "\t\tif(" + ctx.game_state + ob.name + "_is_valid(" + convert_raw_to_id(file, ob.name, "i") + "))\n";
+	output += "\t\t\t" + index + "_insert(int32_t(i));\n";
+	output += "\t}\n";
+	output += "}\n";
+
+	auto const find = project_prefix + "find_" + ob.name + "_by_" + p.name;
+	auto const find_params = api_type + " value, int32_t* out, int32_t capacity";
+	header_output += "DCON_LUADLL_API int32_t " + find + "(" + find_params + "); \n";
+	output += "int32_t " + find + "(" + find_params + ") { \n";
+	output += "\tif(" + index + "_dirty)\n";
+	output += "\t\t" + rebuild + "();\n";
+	output += "\tauto it = " + index + ".find(int64_t(value));\n";
+	output += "\tif(it == " + index + ".end())\n";
+	output += "\t\treturn 0;\n";
+	output += "\tauto const count = int32_t(it->second.size());\n";
+	output += "\tauto const copied = std::min(count, std::max(capacity, 0));\n";
+	output += "\tif(copied > 0)\n";
+	output += "\t\tstd::memcpy(out, it->second.data(), sizeof(int32_t) * size_t(copied));\n";
+	output += "\treturn count;\n";
+	output += "}\n";
+
+	lua_cdef += "void " + rebuild + "();\n";
+	lua_cdef += "int32_t " + find + "(" + find_params + ");\n";
+
+	lua_cdef_wrapper += "function " + lua_namespace + ".rebuild_" + p.name + "_index()\n";
+	lua_cdef_wrapper += "\tffi.C." + rebuild + "()\n";
+	lua_cdef_wrapper += "end\n";
+	lua_cdef_wrapper += "---writes up to capacity ids into out and returns how many match in total\n";
+	if(is_handle) {
+		lua_cdef_wrapper += "---@param value " + lua_id(normalize_type(p.data_type, ctx.made_types).lua_type) + "\n";
+	} else {
+		lua_cdef_wrapper += "---@param value " + std::string(p.type == property_type::bitfield ? "boolean" : "number") + "\n";
+	}
+	lua_cdef_wrapper += "---@param out ffi.cdata*\n";
+	lua_cdef_wrapper += "---@param capacity number\n";
+	lua_cdef_wrapper += "---@return number\n";
+	lua_cdef_wrapper += "function " + lua_namespace + ".find_by_" + p.name + "(value, out, capacity)\n";
+	lua_cdef_wrapper += "\treturn ffi.C." + find + "(value, out, capacity)\n";
+	lua_cdef_wrapper += "end\n";
+
+	return output;
+}
+
+// objects whose live ids have holes or move, and which are only created and deleted through the generated bindings
+bool has_live_list(relationship_object_def const& ob) {
+	return !ob.is_relationship && (ob.store_type == storage_type::erasable || ob.store_type == storage_type::compactable);
+}
+
+// dense list of the live ids of an object, with the position of every id in it for constant time removal;
+// like the property indexes it starts dirty and is rebuilt by the next read once marked dirty
+std::string make_live_list(generation_context const& ctx, file_def& file, std::string const& project_prefix, relationship_object_def const& ob, std::string& header_output, std::string& lua_cdef, std::string& lua_cdef_wrapper, std::string const& lua_namespace) {
+	std::string output;
+	auto const live = project_prefix + ob.name + "_live";
+	output += "std::vector<int32_t> " + live + ";\n";
+	output += "std::vector<int32_t> " + live + "_slot;\n";
+	output += "bool " + live + "_dirty = true;\n";
+
+	output += "void " + live + "_insert(int32_t id) { \n";
+	output += "\tif(" + live + "_dirty)\n";
+	output += "\t\treturn;\n";
+	output += "\tif(" + live + "_slot.size() <= size_t(id))\n";
+	output += "\t\t" + live + "_slot.resize(size_t(id) + 1, -1);\n";
+	output += "\tif(" + live + "_slot[id] >= 0)\n";
+	output += "\t\treturn;\n";
+	output += "\t" + live + "_slot[id] = int32_t(" + live + ".size());\n";
+	output += "\t" + live + ".push_back(id);\n";
+	output += "}\n";
+
+	output += "void " + live + "_remove(int32_t id) { \n";
+	output += "\tif(" + live + "_dirty || size_t(id) >= " + live + "_slot.size() || " + live + "_slot[id] < 0)\n";
+	output += "\t\treturn;\n";
+	output += "\tauto moved = " + live + ".back();\n";
+	output += "\t" + live + "[" + live + "_slot[id]] = moved;\n";
+	output += "\t" + live + "_slot[moved] = " + live + "_slot[id];\n";
+	output += "\t" + live + ".pop_back();\n";
+	output += "\t" + live + "_slot[id] = -1;\n";
+	output += "}\n";
+
+	auto const rebuild = project_prefix + ob.name + "_rebuild_live_ids";
+	header_output += "DCON_LUADLL_API void " + rebuild + "(); \n";
+	output += "void " + rebuild + "() { \n";
+	output += "\tuint32_t const size = " + ctx.game_state + ob.name + "_size();\n";
+	output += "\t" + live + ".clear();\n";
+	output += "\t" + live + "_slot.assign(size, -1);\n";
+	output += "\t" + live + "_dirty = false;\n";
+	output += "\tfor(uint32_t i = 0; i < size; ++i) {\n";
+	output += "\t\tif(" + ctx.game_state + ob.name + "_is_valid(" + convert_raw_to_id(file, ob.name, "i") + "))\n";
+	output += "\t\t\t" + live + "_insert(int32_t(i));\n";
+	output += "\t}\n";
+	output += "}\n";
+
+	header_output += "DCON_LUADLL_API int32_t const* " + project_prefix + ob.name + "_live_ids(); \n";
+	output += "int32_t const* " + project_prefix + ob.name + "_live_ids() { \n";
+	output += "\tif(" + live + "_dirty)\n";
+	output += "\t\t" + rebuild + "();\n";
+	output += "\treturn " + live + ".data();\n";
+	output += "}\n";
+	header_output += "DCON_LUADLL_API uint32_t " + project_prefix + ob.name + "_live_count(); \n";
+	output += "uint32_t " + project_prefix + ob.name + "_live_count() { \n";
+	output += "\tif(" + live + "_dirty)\n";
+	output += "\t\t" + rebuild + "();\n";
+	output += "\treturn uint32_t(" + live + ".size());\n";
+	output += "}\n";
+
+	lua_cdef += "void " + rebuild + "();\n";
+	lua_cdef += "int32_t const* " + project_prefix + ob.name + "_live_ids();\n";
+	lua_cdef += "uint32_t " + project_prefix + ob.name + "_live_count();\n";
+
+	lua_cdef_wrapper += "function " + lua_namespace + ".rebuild_live_ids()\n";
+	lua_cdef_wrapper += "\tffi.C." + rebuild + "()\n";
+	lua_cdef_wrapper += "end\n";
+	lua_cdef_wrapper += "---live ids in no particular order, indexed from 0; the pointer is only good until the next create or delete\n";
+	lua_cdef_wrapper += "---@return ffi.cdata* ids\n";
+	lua_cdef_wrapper += "---@return number count\n";
+	lua_cdef_wrapper += "function " + lua_namespace + ".live_ids()\n";
+	lua_cdef_wrapper += "\treturn ffi.C." + project_prefix + ob.name + "_live_ids(), ffi.C." + project_prefix + ob.name + "_live_count()\n";
+	lua_cdef_wrapper += "end\n";
+	return output;
+}
+
+// calls to rebuild every index of an object, for operations which may move or renumber many ids
+std::string rebuild_object_indexes(generation_context const& ctx, std::string const& indent, std::string const& project_prefix, relationship_object_def const& ob) {
+	std::string result;
+	for(auto p : indexed_properties(ctx, ob))
+		result += indent + project_prefix + ob.name + "_rebuild_" + p->name + "_index();\n";
+	if(has_live_list(ob))
+		result += indent + project_prefix + ob.name + "_rebuild_live_ids();\n";
+	return result;
+}
+
+bool has_native_indexes(generation_context const& ctx, file_def const& file) {
+	for(auto& ob : file.relationship_objects) {
+		if(indexed_properties(ctx, ob).size() > 0 || has_live_list(ob))
+			return true;
+	}
+	return false;
+}
+
+// per target counts over the handle properties and single links of an object, optionally weighted by one of its numeric columns;
+// the weight is chosen by its position among the numeric columns, which the Lua side exposes by name
+std::string make_histograms(generation_context const& ctx, file_def& file, std::string const& project_prefix, relationship_object_def const& ob, std::string& header_output, std::string& lua_cdef, std::string& lua_cdef_wrapper, std::string const& lua_namespace) {
+	std::vector<std::string> keys;
+	for(auto& p : ob.properties) {
+		if(p.is_derived || (p.type != property_type::vectorizable && p.type != property_type::other))
+			continue;
+		if(normalize_type(p.data_type, ctx.made_types).normalized == lua_type_match::handle_to_integer)
+			keys.push_back(p.name);
+	}
+	for(auto& l : ob.indexed_objects) {
+		if(l.multiplicity == 1)
+			keys.push_back(l.property_name);
+	}
+	std::vector<std::string> weights;
+	for(auto& p : ob.properties) {
+		if(p.is_derived || (p.type != property_type::vectorizable && p.type != property_type::other))
+			continue;
+		auto t = normalize_type(p.data_type, ctx.made_types);
+		if(t.normalized == lua_type_match::fat_float && t.c_type != "bool")
+			weights.push_back(p.name);
+	}
+	if(keys.empty())
+		return "";
+
+	std::string output;
+	auto const validity = ob.store_type == storage_type::erasable
+		? "\t\tif(!" + ctx.game_state + ob.name + "_is_valid(index))\n\t\t\tcontinue;\n"
+		: std::string("");
+	auto loop = [&](std::string const& key, std::string const& accumulate) {
+		std::string result;
+		result += "\tfor(uint32_t i = 0; i < size; ++i) {\n";
+		result += "\t\tauto index = " + convert_raw_to_id(file, ob.name, "i") + ";\n";
+		result += validity;
+		result += "\t\tauto target = " + ctx.game_state + ob.name + "_get_" + key + "(index).index();\n";
+		result += "\t\tif(target >= 0 && target < n_targets)\n";
+		result += "\t\t\t" + accumulate + ";\n";
+		result += "\t}\n";
+		return result;
+	};
+
+	if(weights.size() > 0) {
+		lua_cdef_wrapper += lua_namespace + ".numeric_columns = {";
+		for(size_t i = 0; i < weights.size(); ++i)
+			lua_cdef_wrapper += (i == 0 ? " " : ", ") + weights[i] + " = " + std::to_string(i);
+		lua_cdef_wrapper += " }\n";
+	}
+
+	for(auto& key : keys) {
+		auto const count = project_prefix + ob.name + "_count_by_" + key;
+		header_output += "DCON_LUADLL_API void " + count + "(int32_t* out_counts, int32_t n_targets); \n";
+		output += "void " + count + "(int32_t* out_counts, int32_t n_targets) { \n";
+		output += "\tfor(int32_t i = 0; i < n_targets; ++i)\n";
+		output += "\t\tout_counts[i] = 0;\n";
+		output += "\tuint32_t const size = " + ctx.game_state + ob.name + "_size();\n";
+		output += loop(key, "++out_counts[target]");
+		output += "}\n";
+
+		lua_cdef += "void " + count + "(int32_t* out_counts, int32_t n_targets);\n";
+		lua_cdef_wrapper += "---@param out_counts ffi.cdata*\n";
+		lua_cdef_wrapper += "---@param n_targets number\n";
+		lua_cdef_wrapper += "function " + lua_namespace + ".count_by_" + key + "(out_counts, n_targets)\n";
+		lua_cdef_wrapper += "\tffi.C." + count + "(out_counts, n_targets)\n";
+		lua_cdef_wrapper += "end\n";
+
+		if(weights.empty())
+			continue;
+
+		auto const weighted = project_prefix + ob.name + "_weighted_count_by_" + key;
+		header_output += "DCON_LUADLL_API bool " + weighted + "(int32_t column, double* out_sums, int32_t n_targets); \n";
+		output += "bool " + weighted + "(int32_t column, double* out_sums, int32_t n_targets) { \n";
+		output += "\tfor(int32_t i = 0; i < n_targets; ++i)\n";
+		output += "\t\tout_sums[i] = 0.0;\n";
+		output += "\tuint32_t const size = " + ctx.game_state + ob.name + "_size();\n";
+		output += "\tswitch(column) {\n";
+		for(size_t i = 0; i < weights.size(); ++i) {
+			output += "\tcase " + std::to_string(i) + ":\n";
+			output += loop(key, "out_sums[target] += double(" + ctx.game_state + ob.name + "_get_" + weights[i] + "(index))");
+			output += "\t\treturn true;\n";
+		}
+		output += "\tdefault:\n";
+		output += "\t\treturn false;\n";
+		output += "\t}\n";
+		output += "}\n";
+
+		lua_cdef += "bool " + weighted + "(int32_t column, double* out_sums, int32_t n_targets);\n";
+		lua_cdef_wrapper += "---@param column string|number name or position in numeric_columns\n";
+		lua_cdef_wrapper += "---@param out_sums ffi.cdata*\n";
+		lua_cdef_wrapper += "---@param n_targets number\n";
+		lua_cdef_wrapper += "---@return boolean\n";
+		lua_cdef_wrapper += "function " + lua_namespace + ".weighted_count_by_" + key + "(column, out_sums, n_targets)\n";
+		lua_cdef_wrapper += "\tif type(column) == \"string\" then column = " + lua_namespace + ".numeric_columns[column] end\n";
+		lua_cdef_wrapper += "\treturn ffi.C." + weighted + "(column or -1, out_sums, n_targets)\n";
+		lua_cdef_wrapper += "end\n";
+	}
+	return output;
+}
+
+// reads a scalar property of the objects reached through a single link, for a whole buffer of ids;
+// each batch first resolves all of its links and then reads all of its targets, so that the two loads do not wait on each other
+std::string make_gathers(generation_context const& ctx, file_def& file, std::string const& project_prefix, relationship_object_def const& ob, std::string& header_output, std::string& lua_cdef, std::string& lua_cdef_wrapper, std::string const& lua_namespace) {
+	struct hop {
+		std::string name; // as it appears in the generated function name
+		std::string resolve; // expression of the linked id, from index
+		relationship_object_def const* target;
+	};
+	std::vector<hop> hops;
+	auto const get = ctx.game_state + ob.name + "_get_";
+	for(auto& p : ob.properties) {
+		if(p.is_derived || (p.type != property_type::vectorizable && p.type != property_type::other))
+			continue;
+		for(auto& t : file.relationship_objects) {
+			if(p.data_type == t.name + "_id")
+				hops.push_back(hop{ p.name, get + p.name + "(index)", &t });
+		}
+	}
+	for(auto& l : ob.indexed_objects) {
+		if(l.multiplicity == 1 && l.related_to)
+			hops.push_back(hop{ l.property_name, get + l.property_name + "(index)", l.related_to });
+	}
+	for(auto& r : ob.relationships_involved_in) {
+		if(r.linked_as->index != index_type::at_most_one || r.linked_as->multiplicity != 1)
+			continue;
+		for(auto& l : r.rel_ptr->indexed_objects) {
+			if(&l == r.linked_as || l.multiplicity != 1 || !l.related_to)
+				continue;
+			hops.push_back(hop{ l.property_name + "_from_" + r.relation_name,
+				ctx.game_state + r.relation_name + "_get_" + l.property_name + "(" + get + r.relation_name + "_as_" + r.linked_as->property_name + "(index))",
+				l.related_to });
+		}
+	}
+
+	std::string output;
+	for(auto& h : hops) {
+		for(auto& p : h.target->properties) {
+			if(p.is_derived || (p.type != property_type::vectorizable && p.type != property_type::other && p.type != property_type::bitfield))
+				continue;
+			auto const is_bool = p.type == property_type::bitfield;
+			auto t = normalize_type(p.data_type, ctx.made_types);
+			if(!is_bool && t.normalized != lua_type_match::fat_float && t.normalized != lua_type_match::handle_to_integer)
+				continue;
+			auto const is_handle = !is_bool && t.normalized == lua_type_match::handle_to_integer;
+			auto const out_type = is_bool ? std::string("bool") : t.api_type;
+			auto const fallback = is_bool ? std::string("false") : is_handle ? std::string("-1") : out_type + "{}";
+
+			auto const fname = project_prefix + ob.name + "_gather_" + h.name + "_" + p.name;
+			auto const params = "int32_t const* ids, int32_t count, " + out_type + "* out";
+			header_output += "DCON_LUADLL_API void " + fname + "(" + params + "); \n";
+			output += "void " + fname + "(" + params + ") { \n";
+			output += "\tint32_t targets[256];\n";
+			output += "\tfor(int32_t base = 0; base < count; base += 256) {\n";
+			output += "\t\tint32_t const n = count - base < 256 ? count - base : 256;\n";
+			output += "\t\tfor(int32_t k = 0; k < n; ++k) {\n";
+			output += "\t\t\tauto index = " + convert_raw_to_id(file, ob.name, "ids[base + k]") + ";\n";
+			output += "\t\t\ttargets[k] = " + h.resolve + ".index();\n";
+			output += "\t\t}\n";
+			output += "\t\tfor(int32_t k = 0; k < n; ++k) {\n";
+			auto const read = ctx.game_state + h.target->name + "_get_" + p.name + "(" + convert_raw_to_id(file, h.target->name, "targets[k]") + ")" + (is_handle ? ".index()" : "");
+			output += "\t\t\tout[base + k] = targets[k] >= 0 ? " + read + " : " + fallback + ";\n";
+			output += "\t\t}\n";
+			output += "\t}\n";
+			output += "}\n";
+
+			lua_cdef += "void " + fname + "(" + params + ");\n";
+			lua_cdef_wrapper += "---@param ids ffi.cdata*\n";
+			lua_cdef_wrapper += "---@param count number\n";
+			lua_cdef_wrapper += "---@param out ffi.cdata*\n";
+			lua_cdef_wrapper += "function " + lua_namespace + ".gather_" + h.name + "_" + p.name + "(ids, count, out)\n";
+			lua_cdef_wrapper += "\tffi.C." + fname + "(ids, count, out)\n";
+			lua_cdef_wrapper += "end\n";
+		}
+	}
+	return output;
+}
+
+// resumable scans over the live ids of an object, optionally restricted to those with a bitfield property set;
+// cursors are slots in a table which are reused once closed
+std::string make_cursors(generation_context const& ctx, file_def& file, std::string const& project_prefix, relationship_object_def const& ob, std::string& header_output, std::string& lua_cdef, std::string& lua_cdef_wrapper, std::string const& lua_namespace) {
+	std::vector<std::string> filters;
+	for(auto& p : ob.properties) {
+		if(!p.is_derived && p.type == property_type::bitfield)
+			filters.push_back(p.name);
+	}
+	auto const table = project_prefix + ob.name + "_cursor_table";
+	auto const open = project_prefix + ob.name + "_cursor_open";
+	auto const next = project_prefix + ob.name + "_cursor_next";
+	auto const close = project_prefix + ob.name + "_cursor_close";
+
+	std::string output;
+	output += "struct " + project_prefix + ob.name + "_cursor {\n";
+	output += "\tuint32_t position = 0;\n";
+	output += "\tint32_t filter = -1;\n";
+	output += "\tbool in_use = false;\n";
+	output += "};\n";
+	output += "std::vector<" + project_prefix + ob.name + "_cursor> " + table + ";\n";
+
+	header_output += "DCON_LUADLL_API int32_t " + open + "(int32_t filter); \n";
+	output += "int32_t " + open + "(int32_t filter) { \n";
+	output += "\tif(filter < -1 || filter >= " + std::to_string(filters.size()) + ")\n";
+	output += "\t\treturn -1;\n";
+	output += "\tsize_t slot = 0;\n";
+	output += "\twhile(slot < " + table + ".size() && " + table + "[slot].in_use)\n";
+	output += "\t\t++slot;\n";
+	output += "\tif(slot == " + table + ".size())\n";
+	output += "\t\t" + table + ".emplace_back();\n";
+	output += "\t" + table + "[slot] = " + project_prefix + ob.name + "_cursor{ 0, filter, true };\n";
+	output += "\treturn int32_t(slot);\n";
+	output += "}\n";
+
+	header_output += "DCON_LUADLL_API int32_t " + next + "(int32_t cursor, int32_t* out_ids, int32_t max); \n";
+	output += "int32_t " + next + "(int32_t cursor, int32_t* out_ids, int32_t max) { \n";
+	output += "\tif(cursor < 0 || size_t(cursor) >= " + table + ".size() || !" + table + "[cursor].in_use)\n";
+	output += "\t\treturn 0;\n";
+	output += "\tauto& c = " + table + "[cursor];\n";
+	output += "\tuint32_t const size = " + ctx.game_state + ob.name + "_size();\n";
+	output += "\tint32_t count = 0;\n";
+	output += "\tfor(; c.position < size && count < max; ++c.position) {\n";
+	if(ob.store_type == storage_type::erasable || filters.size() > 0)
+		output += "\t\tauto index = " + convert_raw_to_id(file, ob.name, "c.position") + ";\n";
+	if(ob.store_type == storage_type::erasable) {
+		output += "\t\tif(!" + ctx.game_state + ob.name + "_is_valid(index))\n";
+		output += "\t\t\tcontinue;\n";
+	}
+	if(filters.size() > 0) {
+		output += "\t\tbool passes = true;\n";
+		output += "\t\tswitch(c.filter) {\n";
+		for(size_t i = 0; i < filters.size(); ++i) {
+			output += "\t\tcase " + std::to_string(i) + ":\n";
+			output += "\t\t\tpasses = " + ctx.game_state + ob.name + "_get_" + filters[i] + "(index);\n";
+			output += "\t\t\tbreak;\n";
+		}
+		output += "\t\tdefault:\n";
+		output += "\t\t\tbreak;\n";
+		output += "\t\t}\n";
+		output += "\t\tif(!passes)\n";
+		output += "\t\t\tcontinue;\n";
+	}
+	output += "\t\tout_ids[count++] = int32_t(c.position);\n";
+	output += "\t}\n";
+	output += "\treturn count;\n";
+	output += "}\n";
+
+	header_output += "DCON_LUADLL_API void " + close + "(int32_t cursor); \n";
+	output += "void " + close + "(int32_t cursor) { \n";
+	output += "\tif(cursor >= 0 && size_t(cursor) < " + table + ".size())\n";
+	output += "\t\t" + table + "[cursor].in_use = false;\n";
+	output += "}\n";
+
+	lua_cdef += "int32_t " + open + "(int32_t filter);\n";
+	lua_cdef += "int32_t " + next + "(int32_t cursor, int32_t* out_ids, int32_t max);\n";
+	lua_cdef += "void " + close + "(int32_t cursor);\n";
+
+	if(filters.size() > 0) {
+		lua_cdef_wrapper += lua_namespace + ".cursor_filters = {";
+		for(size_t i = 0; i < filters.size(); ++i)
+			lua_cdef_wrapper += (i == 0 ? " " : ", ") + filters[i] + " = " + std::to_string(i);
+		lua_cdef_wrapper += " }\n";
+	}
+	lua_cdef_wrapper += "---@param filter string|number|nil name or position in cursor_filters, nil for every live id\n";
+	lua_cdef_wrapper += "---@return number cursor, or -1 for an unknown filter\n";
+	lua_cdef_wrapper += "function " + lua_namespace + ".cursor_open(filter)\n";
+	if(filters.size() > 0)
+		lua_cdef_wrapper += "\tif type(filter) == \"string\" then filter = " + lua_namespace + ".cursor_filters[filter] or -2 end\n";
+	lua_cdef_wrapper += "\treturn ffi.C." + open + "(filter or -1)\n";
+	lua_cdef_wrapper += "end\n";
+	lua_cdef_wrapper += "---fills out_ids with up to max further ids; returns 0 once the scan is complete\n";
+	lua_cdef_wrapper += "---@param cursor number\n";
+	lua_cdef_wrapper += "---@param out_ids ffi.cdata*\n";
+	lua_cdef_wrapper += "---@param max number\n";
+	lua_cdef_wrapper += "---@return number\n";
+	lua_cdef_wrapper += "function " + lua_namespace + ".cursor_next(cursor, out_ids, max)\n";
+	lua_cdef_wrapper += "\treturn ffi.C." + next + "(cursor, out_ids, max)\n";
+	lua_cdef_wrapper += "end\n";
+	lua_cdef_wrapper += "---@param cursor number\n";
+	lua_cdef_wrapper += "function " + lua_namespace + ".cursor_close(cursor)\n";
+	lua_cdef_wrapper += "\tffi.C." + close + "(cursor)\n";
+	lua_cdef_wrapper += "end\n";
+	return output;
+}
+
+// splits a global declaration such as "uint32_t current_date;" into its type and name;
+// fails for arrays, pointers, references and templates
+bool parse_global_declaration(file_def const& file, std::string const& declaration, std::string& type, std::string& name) {
+	auto decl = declaration;
+	if(auto end = decl.find_first_of(";="); end != std::string::npos)
+		decl = decl.substr(0, end);
+	decl = trim(decl);
+	if(decl.find_first_of("&*<[") != std::string::npos)
+		return false;
+	auto split = decl.find_last_of(" \t");
+	if(split == std::string::npos)
+		return false;
+	name = trim(decl.substr(split + 1));
+	type = trim(decl.substr(0, split));
+	if(type.compare(0, 6, "const ") == 0)
+		return false;
+	auto const ns = file.namspace + "::";
+	if(type.compare(0, ns.size(), ns) == 0)
+		type = type.substr(ns.size());
+	return !name.empty() && !type.empty();
+}
+
+// accessors for the container's global values; returns the contents of _globals.lua, or nothing if there are none
+std::string make_globals(generation_context const& ctx, file_def& file, std::string const& project_prefix, std::string& output, std::string& header_output) {
+	std::string lua_cdef;
+	std::string lua_wrapper;
+	for(auto& g : file.globals) {
+		std::string type;
+		std::string name;
+		if(!parse_global_declaration(file, g, type, name))
+			continue;
+		auto arg = normalize_argument(ctx, "value", false, type);
+		if(arg.meta_type == meta_information::value_pointer)
+			continue;
+		auto const& api_type = arg.type.api_type;
+		auto const global = ctx.game_state + name;
+		auto const lua_type = arg.meta_type == meta_information::id ? lua_id(arg.type.c_type) : arg.type.lua_type;
+
+		header_output += "DCON_LUADLL_API " + api_type + " " + project_prefix + "get_global_" + name + "(); \n";
+		output += api_type + " " + project_prefix + "get_global_" + name + "() { \n";
+		if(arg.meta_type == meta_information::id) {
+			output += "\treturn " + global + ".index();\n";
+		} else {
+			output += "\treturn " + global + ";\n";
+		}
+		output += "}\n";
+
+		header_output += "DCON_LUADLL_API void " + project_prefix + "set_global_" + name + "(" + api_type + " value); \n";
+		output += "void " + project_prefix + "set_global_" + name + "(" + api_type + " value) { \n";
+		if(arg.meta_type == meta_information::id) {
+			output += "\t" + global + " = " + convert_raw_to_id_from_id(file, arg.type.c_type, "value") + ";\n";
+		} else {
+			output += "\t" + global + " = value;\n";
+		}
+		output += "}\n";
+
+		lua_cdef += api_type + " " + project_prefix + "get_global_" + name + "();\n";
+		lua_cdef += "void " + project_prefix + "set_global_" + name + "(" + api_type + " value);\n";
+
+		lua_wrapper += "---@return " + lua_type + "\n";
+		lua_wrapper += "function GLOBALS.get_" + name + "()\n";
+		lua_wrapper += "\treturn ffi.C." + project_prefix + "get_global_" + name + "()\n";
+		lua_wrapper += "end\n";
+		lua_wrapper += "---@param value " + lua_type + "\n";
+		lua_wrapper += "function GLOBALS.set_" + name + "(value)\n";
+		lua_wrapper += "\tffi.C." + project_prefix + "set_global_" + name + "(value)\n";
+		lua_wrapper += "end\n";
+
+		// ids are stored offset by one and lua references need their lifetime managed, so only plain values are shared directly
+		if(arg.meta_type == meta_information::value && arg.type.normalized != lua_type_match::lua_object) {
+			header_output += "DCON_LUADLL_API " + api_type + "* " + project_prefix + "global_" + name + "_pointer(); \n";
+			output += api_type + "* " + project_prefix + "global_" + name + "_pointer() { \n";
+			output += "\tstatic_assert(std::is_trivially_copyable_v<std::remove_reference_t<decltype(" + global + ")>> && sizeof(" + global + ") == sizeof(" + api_type + "));\n";
+			output += "\treturn reinterpret_cast<" + api_type + "*>(&" + global + ");\n";
+			output += "}\n";
+
+			lua_cdef += api_type + "* " + project_prefix + "global_" + name + "_pointer();\n";
+
+			lua_wrapper += "---pointer to the value itself; fetch it once and index [0] to read or write without a call\n";
+			lua_wrapper += "---@return ffi.cdata*\n";
+			lua_wrapper += "function GLOBALS." + name + "_pointer()\n";
+			lua_wrapper += "\treturn ffi.C." + project_prefix + "global_" + name + "_pointer()\n";
+			lua_wrapper += "end\n";
+		}
+	}
+	if(lua_cdef.empty())
+		return "";
+
+	std::string lua_file = "-- GENERATED FILE: DO NOT EDIT --\n";
+	lua_file += "--   PROVIDES FFI DECLARATIONS --\n";
+	lua_file += "local ffi = require(\"ffi\")\n\n";
+	lua_file += "ffi.cdef[[\n";
+	lua_file += lua_cdef;
+	lua_file += "]]\n";
+	lua_file += "GLOBALS = {}\n";
+	lua_file += lua_wrapper;
+	return lua_file;
+}
+
+// translates the statements of a kernel into calls made on the container's vector ids;
+// only float columns of the kernel's object, numeric parameters, literals, + - * / ( ) and min / max are accepted
+bool compile_kernel(generation_context const& ctx, file_def const& file, kernel_def const& k, std::string& body, std::string& error) {
+	auto ob = std::find_if(file.relationship_objects.begin(), file.relationship_objects.end(), [&](relationship_object_def const& o) { return o.name == k.object; });
+	if(ob == file.relationship_objects.end()) {
+		error = "there is no object named " + k.object;
+		return false;
+	}
+	for(size_t i = 0; i < k.parameter_types.size(); ++i) {
+		auto t = normalize_type(k.parameter_types[i], ctx.made_types);
+		if(t.normalized != lua_type_match::fat_float || t.c_type == "bool") {
+			error = "parameter " + k.parameter_names[i] + " must have a numeric type";
+			return false;
+		}
+	}
+	auto is_column = [&](std::string const& name) {
+		for(auto& p : ob->properties) {
+			if(p.name == name)
+				return !p.is_derived && p.type == property_type::vectorizable && p.data_type == "float";
+		}
+		return false;
+	};
+	auto is_identifier_char = [](char c) { return std::isalnum((unsigned char)c) || c == '_'; };
+	// reads a name, optionally qualified by the kernel's object
+	auto read_name = [&](std::string const& text, size_t& i, std::string& name, bool& qualified) {
+		auto start = i;
+		while(i < text.size() && is_identifier_char(text[i]))
+			++i;
+		name = text.substr(start, i - start);
+		qualified = false;
+		if(i < text.size() && text[i] == '.') {
+			if(name != k.object) {
+				error = name + " is not the object of the kernel";
+				return false;
+			}
+			start = ++i;
+			while(i < text.size() && is_identifier_char(text[i]))
+				++i;
+			name = text.substr(start, i - start);
+			qualified = true;
+		}
+		return true;
+	};
+	// the kind of the last token decides what may follow it, so that malformed expressions are reported here
+	// instead of being emitted as c++ that does not compile
+	enum class token { start, operand, op, open, comma, function };
+	struct paren {
+		bool call = false;
+		int32_t commas = 0;
+	};
+	auto translate = [&](std::string const& text, std::string& out) {
+		token previous = token::start;
+		std::vector<paren> parens;
+		auto expects_operand = [&]() {
+			return previous == token::start || previous == token::op || previous == token::open || previous == token::comma;
+		};
+		auto unexpected = [&](std::string const& what) {
+			error = "unexpected " + what + " in: " + text;
+			return false;
+		};
+		size_t i = 0;
+		while(i < text.size()) {
+			char c = text[i];
+			if(previous == token::function && c != '(' && c != ' ' && c != '\t' && c != '\r' && c != '\n')
+				return unexpected(std::string("\"") + c + "\" after min or max");
+			if(c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+				++i;
+			} else if(std::isalpha((unsigned char)c) || c == '_') {
+				if(!expects_operand())
+					return unexpected("name after an operand");
+				std::string name;
+				bool qualified = false;
+				if(!read_name(text, i, name, qualified))
+					return false;
+				auto next = text.find_first_not_of(" \t\r\n", i);
+				bool const called = next != std::string::npos && text[next] == '(';
+				if(!qualified && (name == "min" || name == "max") && called) {
+					out += "ve::" + name;
+					previous = token::function;
+					continue;
+				} else if(called) {
+					error = name + " is not a function; only min and max may be called";
+					return false;
+				} else if(!qualified && std::find(k.parameter_names.begin(), k.parameter_names.end(), name) != k.parameter_names.end()) {
+					out += "float(" + name + ")";
+				} else if(is_column(name)) {
+					out += ctx.game_state + k.object + "_get_" + name + "(ids)";
+				} else {
+					error = name + " is not a float property of " + k.object + " or a parameter";
+					return false;
+				}
+				previous = token::operand;
+			} else if(std::isdigit((unsigned char)c) || c == '.') {
+				if(!expects_operand())
+					return unexpected("number after an operand");
+				auto start = i;
+				while(i < text.size() && (is_identifier_char(text[i]) || text[i] == '.'
+					|| ((text[i] == '-' || text[i] == '+') && (text[i - 1] == 'e' || text[i - 1] == 'E')))) {
+					++i;
+				}
+				float parsed = 0.0f;
+				auto const literal = text.substr(start, i - start);
+				auto const result = std::from_chars(literal.data(), literal.data() + literal.size(), parsed);
+				if(result.ec != std::errc() || result.ptr != literal.data() + literal.size()) {
+					error = literal + " is not a number";
+					return false;
+				}
+				out += "float(" + literal + ")";
+				previous = token::operand;
+			} else if(c == '+' || c == '-' || c == '*' || c == '/') {
+				// + and - in place of an operand are signs, the others need a left hand side
+				if(expects_operand() && c != '+' && c != '-')
+					return unexpected(std::string("operator ") + c);
+				out += std::string(" ") + c + " ";
+				previous = token::op;
+				++i;
+			} else if(c == ',') {
+				if(previous != token::operand || parens.empty() || !parens.back().call || parens.back().commas > 0)
+					return unexpected("\",\"");
+				++parens.back().commas;
+				out += ", ";
+				previous = token::comma;
+				++i;
+			} else if(c == '(') {
+				if(!expects_operand() && previous != token::function)
+					return unexpected("\"(\" after an operand");
+				parens.push_back(paren{ previous == token::function, 0 });
+				out += c;
+				previous = token::open;
+				++i;
+			} else if(c == ')') {
+				if(parens.empty()) {
+					error = "unbalanced parentheses";
+					return false;
+				}
+				if(previous != token::operand)
+					return unexpected("\")\"");
+				if(parens.back().call && parens.back().commas != 1) {
+					error = "min and max take two arguments in: " + text;
+					return false;
+				}
+				parens.pop_back();
+				out += c;
+				previous = token::operand;
+				++i;
+			} else {
+				error = std::string("unexpected character ") + c;
+				return false;
+			}
+		}
+		if(!parens.empty()) {
+			error = "unbalanced parentheses";
+			return false;
+		}
+		if(previous != token::operand) {
+			error = "incomplete expression: " + text;
+			return false;
+		}
+		return true;
+	};
+
+	for(auto& statement : k.statements) {
+		auto assign = statement.find('=');
+		if(assign == std::string::npos || assign == 0) {
+			error = "expected an assignment in: " + statement;
+			return false;
+		}
+		std::string op;
+		auto lhs_end = assign;
+		if(statement[assign - 1] == '+' || statement[assign - 1] == '-' || statement[assign - 1] == '*' || statement[assign - 1] == '/') {
+			op = statement.substr(assign - 1, 1);
+			lhs_end = assign - 1;
+		}
+		auto lhs = trim(statement.substr(0, lhs_end));
+		size_t i = 0;
+		std::string target;
+		bool qualified = false;
+		if(!read_name(lhs, i, target, qualified))
+			return false;
+		if(i != lhs.size() || !is_column(target)) {
+			error = lhs + " is not a float property of " + k.object;
+			return false;
+		}
+		std::string value;
+		if(!translate(statement.substr(assign + 1), value))
+			return false;
+		if(op.size() > 0)
+			value = ctx.game_state + k.object + "_get_" + target + "(ids) " + op + " (" + value + ")";
+		body += "\t\t" + ctx.game_state + k.object + "_set_" + target + "(ids, " + value + ");\n";
+	}
+	return true;
+}
+
+bool has_events(relationship_object_def const& ob) {
+	return std::find(ob.obj_tags.begin(), ob.obj_tags.end(), "lua_events") != ob.obj_tags.end();
+}
+
+bool has_events(file_def const& file) {
+	for(auto& ob : file.relationship_objects) {
+		if(has_events(ob))
+			return true;
+	}
+	return false;
+}
+
+// multiple producer, single consumer ring of lifecycle events pushed by the bindings of objects tagged lua_events;
+// bindings may run on pool workers, so producers reserve a slot by advancing head and publish it through the slot's
+// sequence number, which the consumer waits for. Events which do not fit are counted and dropped, so that a consumer
+// which falls behind can rescan instead
+std::string make_event_ring(std::string const& project_prefix, std::string& header_output) {
+	std::string output;
+	auto const event = project_prefix + "event";
+	auto const ring = project_prefix + "events";
+
+	header_output += "typedef struct " + event + " { int32_t kind; int32_t object; int32_t id; int32_t link; int32_t slot; int32_t value; } " + event + ";\n";
+
+	// a slot holds position + 1 once its event is published, and position + capacity once it has been drained
+	output += "struct " + project_prefix + "event_ring {\n";
+	output += "\tstatic constexpr uint32_t capacity = 1 << 16;\n";
+	output += "\tstruct slot {\n";
+	output += "\t\tstd::atomic<uint32_t> sequence;\n";
+	output += "\t\t" + event + " value;\n";
+	output += "\t};\n";
+	output += "\tslot entries[capacity];\n";
+	output += "\tstd::atomic<uint32_t> head{ 0 };\n";
+	output += "\tstd::atomic<uint32_t> tail{ 0 };\n";
+	output += "\tstd::atomic<uint64_t> dropped{ 0 };\n";
+	output += "\t" + project_prefix + "event_ring() {\n";
+	output += "\t\tfor(uint32_t i = 0; i < capacity; ++i)\n";
+	output += "\t\t\tentries[i].sequence.store(i, std::memory_order_relaxed);\n";
+	output += "\t}\n";
+	output += "};\n";
+	output += project_prefix + "event_ring " + ring + ";\n";
+
+	output += "void " + project_prefix + "push_event(int32_t kind, int32_t object, int32_t id, int32_t link, int32_t slot, int32_t value) {\n";
+	output += "\tauto position = " + ring + ".head.load(std::memory_order_relaxed);\n";
+	output += "\twhile(true) {\n";
+	output += "\t\tauto& entry = " + ring + ".entries[position & (" + project_prefix + "event_ring::capacity - 1)];\n";
+	output += "\t\tauto const ahead = int32_t(entry.sequence.load(std::memory_order_acquire) - position);\n";
+	output += "\t\tif(ahead == 0) {\n";
+	output += "\t\t\tif(" + ring + ".head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {\n";
+	output += "\t\t\t\tentry.value = " + event + "{ kind, object, id, link, slot, value };\n";
+	output += "\t\t\t\tentry.sequence.store(position + 1, std::memory_order_release);\n";
+	output += "\t\t\t\treturn;\n";
+	output += "\t\t\t}\n";
+	output += "\t\t} else if(ahead < 0) {\n";
+	output += "\t\t\t" + ring + ".dropped.fetch_add(1, std::memory_order_relaxed);\n";
+	output += "\t\t\treturn;\n";
+	output += "\t\t} else {\n";
+	output += "\t\t\tposition = " + ring + ".head.load(std::memory_order_relaxed);\n";
+	output += "\t\t}\n";
+	output += "\t}\n";
+	output += "}\n";
+
+	// stops at the first reserved slot whose event is not published yet, so that events are drained in order
+	header_output += "DCON_LUADLL_API int32_t " + project_prefix + "drain_events(" + event + "* out, int32_t max); \n";
+	output += "int32_t " + project_prefix + "drain_events(" + event + "* out, int32_t max) { \n";
+	output += "\tauto const tail = " + ring + ".tail.load(std::memory_order_relaxed);\n";
+	output += "\tint32_t count = 0;\n";
+	output += "\tfor(; count < max; ++count) {\n";
+	output += "\t\tauto& entry = " + ring + ".entries[(tail + uint32_t(count)) & (" + project_prefix + "event_ring::capacity - 1)];\n";
+	output += "\t\tif(entry.sequence.load(std::memory_order_acquire) != tail + uint32_t(count) + 1)\n";
+	output += "\t\t\tbreak;\n";
+	output += "\t\tout[count] = entry.value;\n";
+	output += "\t\tentry.sequence.store(tail + uint32_t(count) + " + project_prefix + "event_ring::capacity, std::memory_order_release);\n";
+	output += "\t}\n";
+	output += "\t" + ring + ".tail.store(tail + uint32_t(count), std::memory_order_relaxed);\n";
+	output += "\treturn count;\n";
+	output += "}\n";
+
+	header_output += "DCON_LUADLL_API uint64_t " + project_prefix + "dropped_events(); \n";
+	output += "uint64_t " + project_prefix + "dropped_events() { \n";
+	output += "\treturn " + ring + ".dropped.exchange(0, std::memory_order_relaxed);\n";
+	output += "}\n";
+	return output;
+}
+
+std::string make_events_lua(file_def const& file, std::string const& project_prefix) {
+	auto const event = project_prefix + "event";
+	std::string lua = "-- GENERATED FILE: DO NOT EDIT --\n";
+	lua += "--   PROVIDES FFI DECLARATIONS --\n";
+	lua += "local ffi = require(\"ffi\")\n\n";
+	lua += "ffi.cdef[[\n";
+	lua += "typedef struct " + event + " { int32_t kind; int32_t object; int32_t id; int32_t link; int32_t slot; int32_t value; } " + event + ";\n";
+	lua += "int32_t " + project_prefix + "drain_events(" + event + "* out, int32_t max);\n";
+	lua += "uint64_t " + project_prefix + "dropped_events();\n";
+	lua += "]]\n";
+	lua += "EVENTS = {}\n";
+	lua += "EVENTS.kinds = { created = 0, deleted = 1, moved = 2, link_changed = 3 }\n";
+	lua += "EVENTS.objects = {";
+	for(size_t i = 0; i < file.relationship_objects.size(); ++i)
+		lua += (i == 0 ? " " : ", ") + file.relationship_objects[i].name + " = " + std::to_string(i);
+	lua += " }\n";
+	lua += "EVENTS.links = {";
+	bool first = true;
+	for(auto& ob : file.relationship_objects) {
+		if(ob.indexed_objects.empty())
+			continue;
+		lua += std::string(first ? " " : ", ") + ob.name + " = {";
+		for(size_t i = 0; i < ob.indexed_objects.size(); ++i)
+			lua += (i == 0 ? " " : ", ") + ob.indexed_objects[i].property_name + " = " + std::to_string(i);
+		lua += " }";
+		first = false;
+	}
+	lua += " }\n";
+	lua += "---allocates a buffer for drain\n";
+	lua += "---@param size number\n";
+	lua += "---@return ffi.cdata*\n";
+	lua += "function EVENTS.buffer(size)\n";
+	lua += "\treturn ffi.new(\"" + event + "[?]\", size)\n";
+	lua += "end\n";
+	lua += "---moves up to max pending events into buffer; a moved event carries the old id in value, a link change the new target\n";
+	lua += "---and, for links of several slots, the changed slot in slot\n";
+	lua += "---@param buffer ffi.cdata*\n";
+	lua += "---@param max number\n";
+	lua += "---@return number\n";
+	lua += "function EVENTS.drain(buffer, max)\n";
+	lua += "\treturn ffi.C." + project_prefix + "drain_events(buffer, max)\n";
+	lua += "end\n";
+	lua += "---number of events lost to a full queue since the last call\n";
+	lua += "---@return number\n";
+	lua += "function EVENTS.dropped()\n";
+	lua += "\treturn tonumber(ffi.C." + project_prefix + "dropped_events())\n";
+	lua += "end\n";
+	return lua;
+}
+
+// persistent worker threads shared by everything the generated code runs in parallel;
+// the calling thread takes part in every job, and a job started from inside a task runs serially on that thread
+std::string make_thread_pool(std::string const& project_prefix) {
+	std::string output;
+	auto const pool = project_prefix + "thread_pool";
+	// each job lives on the heap until the last worker that picked it up lets go of it, so a worker
+	// waking late only finds its job fully claimed and never touches the next one
+	output += "struct " + pool + " {\n";
+	output += "\tstruct job {\n";
+	output += "\t\tstd::function<void(int32_t)> const* task = nullptr;\n";
+	output += "\t\tint32_t count = 0;\n";
+	output += "\t\tstd::atomic<int32_t> next_task{ 0 };\n";
+	output += "\t\tint32_t finished = 0;\n";
+	output += "\t\tstd::exception_ptr error;\n";
+	output += "\t};\n";
+	output += "\tstd::mutex lock;\n";
+	output += "\tstd::mutex job_lock;\n";
+	output += "\tstd::condition_variable wake;\n";
+	output += "\tstd::condition_variable done;\n";
+	output += "\tstd::vector<std::thread> workers;\n";
+	output += "\tstd::shared_ptr<job> current;\n";
+	output += "\tuint64_t generation = 0;\n";
+	output += "\tbool stopping = false;\n";
+	output += "\tstatic inline thread_local bool in_task = false;\n";
+	output += "\n";
+	output += "\t" + pool + "() {\n";
+	output += "\t\tfor(uint32_t i = 1; i < std::thread::hardware_concurrency(); ++i)\n";
+	output += "\t\t\tworkers.emplace_back([this]() { work(); });\n";
+	output += "\t}\n";
+	output += "\t~" + pool + "() {\n";
+	output += "\t\t{\n";
+	output += "\t\t\tstd::lock_guard<std::mutex> guard(lock);\n";
+	output += "\t\t\tstopping = true;\n";
+	output += "\t\t}\n";
+	output += "\t\twake.notify_all();\n";
+	output += "\t\tfor(auto& w : workers)\n";
+	output += "\t\t\tw.join();\n";
+	output += "\t}\n";
+	output += "\t// runs tasks of the job until none are left unclaimed, then reports how many it ran; a task that throws\n";
+	output += "\t// still counts as finished and the first exception is handed back to the caller of run\n";
+	output += "\tvoid drain(job& j) {\n";
+	output += "\t\tint32_t ran = 0;\n";
+	output += "\t\tstd::exception_ptr failure;\n";
+	output += "\t\tin_task = true;\n";
+	output += "\t\tfor(int32_t i = j.next_task++; i < j.count; i = j.next_task++) {\n";
+	output += "\t\t\ttry {\n";
+	output += "\t\t\t\t(*j.task)(i);\n";
+	output += "\t\t\t} catch(...) {\n";
+	output += "\t\t\t\tif(!failure)\n";
+	output += "\t\t\t\t\tfailure = std::current_exception();\n";
+	output += "\t\t\t}\n";
+	output += "\t\t\t++ran;\n";
+	output += "\t\t}\n";
+	output += "\t\tin_task = false;\n";
+	output += "\t\tstd::lock_guard<std::mutex> guard(lock);\n";
+	output += "\t\tif(failure && !j.error)\n";
+	output += "\t\t\tj.error = failure;\n";
+	output += "\t\tj.finished += ran;\n";
+	output += "\t\tif(ran > 0 && j.finished == j.count)\n";
+	output += "\t\t\tdone.notify_all();\n";
+	output += "\t}\n";
+	output += "\tvoid work() {\n";
+	output += "\t\tuint64_t seen = 0;\n";
+	output += "\t\tstd::unique_lock<std::mutex> guard(lock);\n";
+	output += "\t\twhile(true) {\n";
+	output += "\t\t\twake.wait(guard, [&]() { return stopping || generation != seen; });\n";
+	output += "\t\t\tif(stopping)\n";
+	output += "\t\t\t\treturn;\n";
+	output += "\t\t\tseen = generation;\n";
+	output += "\t\t\tauto j = current;\n";
+	output += "\t\t\tif(!j)\n";
+	output += "\t\t\t\tcontinue;\n";
+	output += "\t\t\tguard.unlock();\n";
+	output += "\t\t\tdrain(*j);\n";
+	output += "\t\t\tj.reset();\n";
+	output += "\t\t\tguard.lock();\n";
+	output += "\t\t}\n";
+	output += "\t}\n";
+	output += "\tvoid run(int32_t n, std::function<void(int32_t)> const& fn) {\n";
+	output += "\t\tif(in_task || workers.empty() || n <= 1) {\n";
+	output += "\t\t\tstd::exception_ptr failure;\n";
+	output += "\t\t\tfor(int32_t i = 0; i < n; ++i) {\n";
+	output += "\t\t\t\ttry {\n";
+	output += "\t\t\t\t\tfn(i);\n";
+	output += "\t\t\t\t} catch(...) {\n";
+	output += "\t\t\t\t\tif(!failure)\n";
+	output += "\t\t\t\t\t\tfailure = std::current_exception();\n";
+	output += "\t\t\t\t}\n";
+	output += "\t\t\t}\n";
+	output += "\t\t\tif(failure)\n";
+	output += "\t\t\t\tstd::rethrow_exception(failure);\n";
+	output += "\t\t\treturn;\n";
+	output += "\t\t}\n";
+	output += "\t\tstd::lock_guard<std::mutex> one_job(job_lock);\n";
+	output += "\t\tauto j = std::make_shared<job>();\n";
+	output += "\t\tj->task = &fn;\n";
+	output += "\t\tj->count = n;\n";
+	output += "\t\t{\n";
+	output += "\t\t\tstd::lock_guard<std::mutex> guard(lock);\n";
+	output += "\t\t\tcurrent = j;\n";
+	output += "\t\t\t++generation;\n";
+	output += "\t\t}\n";
+	output += "\t\twake.notify_all();\n";
+	output += "\t\tdrain(*j);\n";
+	output += "\t\tstd::unique_lock<std::mutex> guard(lock);\n";
+	output += "\t\tdone.wait(guard, [&]() { return j->finished == j->count; });\n";
+	output += "\t\tcurrent.reset();\n";
+	output += "\t\tif(j->error)\n";
+	output += "\t\t\tstd::rethrow_exception(j->error);\n";
+	output += "\t}\n";
+	output += "};\n";
+
+	output += pool + "& " + project_prefix + "threads() {\n";
+	output += "\tstatic " + pool + " instance;\n";
+	output += "\treturn instance;\n";
+	output += "}\n";
+
+	output += "void " + project_prefix + "run_tasks(int32_t count, std::function<void(int32_t)> const& task) {\n";
+	output += "\t" + project_prefix + "threads().run(count, task);\n";
+	output += "}\n";
+	return output;
+}
+
+// members of the container's load_record which belong to a single object
+std::vector<std::string> section_record_members(relationship_object_def const& ob) {
+	std::vector<std::string> result;
+	result.push_back(ob.name);
+	if(ob.store_type == storage_type::erasable) {
+		result.push_back(ob.name + "__index");
+	}
+	for(auto& i : ob.indexed_objects) {
+		result.push_back(ob.name + "_" + i.property_name);
+	}
+	for(auto& p : ob.properties) {
+		if(!p.is_derived) {
+			result.push_back(ob.name + "_" + p.name);
+		}
+	}
+	return result;
+}
+
+// objects joined by a relationship share storage during deserialization (resizing an object
+// touches the relationships it is linked by), so they are loaded by the same task
+std::vector<int32_t> section_groups(file_def const& file, int32_t& group_count) {
+	std::vector<int32_t> parent(file.relationship_objects.size());
+	for(size_t i = 0; i < parent.size(); ++i) {
+		parent[i] = int32_t(i);
+	}
+	auto find_root = [&](int32_t i) {
+		while(parent[i] != i) {
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	};
+	for(size_t i = 0; i < file.relationship_objects.size(); ++i) {
+		for(auto& l : file.relationship_objects[i].indexed_objects) {
+			if(l.related_to) {
+				auto a = find_root(int32_t(i));
+				auto b = find_root(int32_t(l.related_to - file.relationship_objects.data()));
+				parent[std::max(a, b)] = std::min(a, b);
+			}
+		}
+	}
+
+	std::vector<int32_t> result(parent.size());
+	std::vector<int32_t> root_to_group(parent.size(), -1);
+	group_count = 0;
+	for(size_t i = 0; i < parent.size(); ++i) {
+		auto root = find_root(int32_t(i));
+		if(root_to_group[root] == -1) {
+			root_to_group[root] = group_count++;
+		}
+		result[i] = root_to_group[root];
+	}
+	return result;
+}
+
+// byte oriented lz77 in the style of lz4: every sequence is a token (literal count << 4 | match length - 4),
+// extra length bytes, the literals, and then a two byte offset and extra match length bytes; the last
+// sequence carries only literals
+std::string make_lz_codec(std::string const& project_prefix) {
+	std::string output;
+
+	output += "std::vector<std::byte> " + project_prefix + "lz_compress(std::byte const* src, size_t n) {\n";
+	output += "\tstd::vector<std::byte> out;\n";
+	output += "\tout.reserve(n / 4 + 16);\n";
+	output += "\tstd::vector<size_t> table(size_t(1) << 16, 0);\n";
+	output += "\tauto put_length = [&](size_t length) {\n";
+	output += "\t\tfor(; length >= 255; length -= 255)\n";
+	output += "\t\t\tout.push_back(std::byte(255));\n";
+	output += "\t\tout.push_back(std::byte(length));\n";
+	output += "\t};\n";
+	output += "\tauto put_sequence = [&](size_t literal_start, size_t literal_end, size_t offset, size_t match_length) {\n";
+	output += "\t\tsize_t const literals = literal_end - literal_start;\n";
+	output += "\t\tsize_t const extra_match = match_length > 0 ? match_length - 4 : 0;\n";
+	output += "\t\tout.push_back(std::byte((std::min(literals, size_t(15)) << 4) | std::min(extra_match, size_t(15))));\n";
+	output += "\t\tif(literals >= 15)\n";
+	output += "\t\t\tput_length(literals - 15);\n";
+	output += "\t\tout.insert(out.end(), src + literal_start, src + literal_end);\n";
+	output += "\t\tif(match_length > 0) {\n";
+	output += "\t\t\tout.push_back(std::byte(offset & 0xFF));\n";
+	output += "\t\t\tout.push_back(std::byte(offset >> 8));\n";
+	output += "\t\t\tif(extra_match >= 15)\n";
+	output += "\t\t\t\tput_length(extra_match - 15);\n";
+	output += "\t\t}\n";
+	output += "\t};\n";
+	output += "\tsize_t anchor = 0;\n";
+	output += "\tsize_t i = 0;\n";
+	output += "\twhile(i + 4 <= n) {\n";
+	output += "\t\tuint32_t v = 0;\n";
+	output += "\t\tstd::memcpy(&v, src + i, 4);\n";
+	output += "\t\tauto& slot = table[(v * 2654435761u) >> 16];\n";
+	output += "\t\tsize_t const candidate = slot;\n";
+	output += "\t\tslot = i + 1;\n";
+	output += "\t\tif(candidate != 0 && i - (candidate - 1) <= 0xFFFF && std::memcmp(src + candidate - 1, src + i, 4) == 0) {\n";
+	output += "\t\t\tsize_t const match = candidate - 1;\n";
+	output += "\t\t\tsize_t length = 4;\n";
+	output += "\t\t\twhile(i + length < n && src[match + length] == src[i + length])\n";
+	output += "\t\t\t\t++length;\n";
+	output += "\t\t\tput_sequence(anchor, i, i - match, length);\n";
+	output += "\t\t\ti += length;\n";
+	output += "\t\t\tanchor = i;\n";
+	output += "\t\t} else {\n";
+	output += "\t\t\t++i;\n";
+	output += "\t\t}\n";
+	output += "\t}\n";
+	output += "\tput_sequence(anchor, n, 0, 0);\n";
+	output += "\treturn out;\n";
+	output += "}\n";
+
+	output += "bool " + project_prefix + "lz_decompress(std::byte const* src, size_t n, std::byte* dst, size_t raw_length) {\n";
+	output += "\tsize_t i = 0;\n";
+	output += "\tsize_t o = 0;\n";
+	output += "\tauto get_length = [&](size_t& length) {\n";
+	output += "\t\tuint8_t b = 255;\n";
+	output += "\t\twhile(b == 255) {\n";
+	output += "\t\t\tif(i >= n)\n";
+	output += "\t\t\t\treturn false;\n";
+	output += "\t\t\tb = uint8_t(src[i++]);\n";
+	output += "\t\t\tlength += b;\n";
+	output += "\t\t}\n";
+	output += "\t\treturn true;\n";
+	output += "\t};\n";
+	output += "\twhile(i < n) {\n";
+	output += "\t\tuint8_t const token = uint8_t(src[i++]);\n";
+	output += "\t\tsize_t literals = token >> 4;\n";
+	output += "\t\tif(literals == 15 && !get_length(literals))\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tif(literals > n - i || literals > raw_length - o)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tif(literals > 0)\n";
+	output += "\t\t\tstd::memcpy(dst + o, src + i, literals);\n";
+	output += "\t\ti += literals;\n";
+	output += "\t\to += literals;\n";
+	output += "\t\tif(i == n)\n";
+	output += "\t\t\tbreak;\n";
+	output += "\t\tif(n - i < 2)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tsize_t const offset = size_t(uint8_t(src[i])) | (size_t(uint8_t(src[i + 1])) << 8);\n";
+	output += "\t\ti += 2;\n";
+	output += "\t\tsize_t length = token & 15;\n";
+	output += "\t\tif(length == 15 && !get_length(length))\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tlength += 4;\n";
+	output += "\t\tif(offset == 0 || offset > o || length > raw_length - o)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tfor(size_t k = 0; k < length; ++k)\n";
+	output += "\t\t\tdst[o + k] = dst[o + k - offset];\n";
+	output += "\t\to += length;\n";
+	output += "\t}\n";
+	output += "\treturn o == raw_length;\n";
+	output += "}\n";
+
+	return output;
+}
+
+// shared code of the section indexed save format:
+// header { "DCLS", uint32_t version, uint32_t section count }
+// section table { uint32_t name length, name, uint64_t offset, uint64_t length, uint64_t raw length, uint8_t codec } per section
+// (version 1 files lack the last two fields) followed by the section contents, each one produced
+// by serialize with a single object selected and, for codec 1, compressed with lz_compress
+std::string make_section_helpers(generation_context const& ctx, file_def const& file, std::string const& project_prefix) {
+	std::string output;
+	int32_t group_count = 0;
+	auto groups = section_groups(file, group_count);
+	auto const section_count = std::to_string(file.relationship_objects.size());
+
+	output += "constexpr int32_t " + project_prefix + "section_count = " + section_count + ";\n";
+	output += "constexpr int32_t " + project_prefix + "section_group_count = " + std::to_string(group_count) + ";\n";
+	output += "static char const* const " + project_prefix + "section_names[] = { ";
+	for(auto& ob : file.relationship_objects) {
+		output += "\"" + ob.name + "\", ";
+	}
+	output += "};\n";
+	output += "static int32_t const " + project_prefix + "section_group_of[] = { ";
+	for(auto g : groups) {
+		output += std::to_string(g) + ", ";
+	}
+	output += "};\n";
+	// relationships are loaded after the objects they link
+	output += "static int32_t const " + project_prefix + "section_load_order[] = { ";
+	for(size_t i = 0; i < file.relationship_objects.size(); ++i) {
+		if(!file.relationship_objects[i].is_relationship)
+			output += std::to_string(i) + ", ";
+	}
+	for(size_t i = 0; i < file.relationship_objects.size(); ++i) {
+		if(file.relationship_objects[i].is_relationship)
+			output += std::to_string(i) + ", ";
+	}
+	output += "};\n";
+	output += "\n";
+
+	output += file.namspace + "::load_record " + project_prefix + "section_record(" + file.namspace + "::load_record const& selection, int32_t section) {\n";
+	output += "\t" + file.namspace + "::load_record result;\n";
+	output += "\tswitch(section) {\n";
+	for(size_t i = 0; i < file.relationship_objects.size(); ++i) {
+		output += "\tcase " + std::to_string(i) + ":\n";
+		for(auto& member : section_record_members(file.relationship_objects[i])) {
+			output += "\t\tresult." + member + " = selection." + member + ";\n";
+		}
+		output += "\t\tbreak;\n";
+	}
+	output += "\t}\n";
+	output += "\treturn result;\n";
+	output += "}\n";
+
+	output += make_lz_codec(project_prefix);
+
+	output += "struct " + project_prefix + "section_statistics {\n";
+	output += "\tuint64_t raw_bytes = 0;\n";
+	output += "\tuint64_t stored_bytes = 0;\n";
+	output += "\tdouble save_seconds = 0.0;\n";
+	output += "\tdouble load_seconds = 0.0;\n";
+	output += "};\n";
+	output += "static " + project_prefix + "section_statistics " + project_prefix + "last_section_statistics;\n";
+
+	output += "void " + project_prefix + "save_sections(char const* name, " + file.namspace + "::load_record const& selection, bool compress) {\n";
+	output += "\tauto const start_time = std::chrono::steady_clock::now();\n";
+	output += "\tstd::vector<std::byte> sections[" + project_prefix + "section_count];\n";
+	output += "\tuint64_t raw_lengths[" + project_prefix + "section_count] = { };\n";
+	output += "\tuint8_t codecs[" + project_prefix + "section_count] = { };\n";
+	output += "\t" + project_prefix + "run_tasks(" + project_prefix + "section_count, [&](int32_t i) {\n";
+	output += "\t\tauto section_selection = " + project_prefix + "section_record(selection, i);\n";
+	output += "\t\tsections[i].resize(size_t(" + ctx.game_state + "serialize_size(section_selection)));\n";
+	output += "\t\tauto ptr = sections[i].data();\n";
+	output += "\t\t" + ctx.game_state + "serialize(ptr, section_selection);\n";
+	output += "\t\traw_lengths[i] = sections[i].size();\n";
+	output += "\t\tif(compress) {\n";
+	output += "\t\t\tauto packed = " + project_prefix + "lz_compress(sections[i].data(), sections[i].size());\n";
+	output += "\t\t\tif(packed.size() < sections[i].size()) {\n";
+	output += "\t\t\t\tsections[i] = std::move(packed);\n";
+	output += "\t\t\t\tcodecs[i] = 1;\n";
+	output += "\t\t\t}\n";
+	output += "\t\t}\n";
+	output += "\t});\n";
+	output += "\tstd::vector<std::byte> header;\n";
+	output += "\tauto put = [&](void const* data, size_t sz) {\n";
+	output += "\t\theader.insert(header.end(), (std::byte const*)data, (std::byte const*)data + sz);\n";
+	output += "\t};\n";
+	output += "\tuint32_t const version = 2;\n";
+	output += "\tuint32_t const count = uint32_t(" + project_prefix + "section_count);\n";
+	output += "\tuint64_t offset = 12;\n";
+	output += "\tfor(int32_t i = 0; i < " + project_prefix + "section_count; ++i)\n";
+	output += "\t\toffset += 29 + std::strlen(" + project_prefix + "section_names[i]);\n";
+	output += "\tput(\"DCLS\", 4);\n";
+	output += "\tput(&version, sizeof(version));\n";
+	output += "\tput(&count, sizeof(count));\n";
+	output += "\t" + project_prefix + "section_statistics statistics;\n";
+	output += "\tfor(int32_t i = 0; i < " + project_prefix + "section_count; ++i) {\n";
+	output += "\t\tuint32_t name_length = uint32_t(std::strlen(" + project_prefix + "section_names[i]));\n";
+	output += "\t\tuint64_t length = sections[i].size();\n";
+	output += "\t\tput(&name_length, sizeof(name_length));\n";
+	output += "\t\tput(" + project_prefix + "section_names[i], name_length);\n";
+	output += "\t\tput(&offset, sizeof(offset));\n";
+	output += "\t\tput(&length, sizeof(length));\n";
+	output += "\t\tput(&raw_lengths[i], sizeof(raw_lengths[i]));\n";
+	output += "\t\tput(&codecs[i], sizeof(codecs[i]));\n";
+	output += "\t\toffset += length;\n";
+	output += "\t\tstatistics.raw_bytes += raw_lengths[i];\n";
+	output += "\t\tstatistics.stored_bytes += length;\n";
+	output += "\t}\n";
+	output += "\tstd::ofstream file_out(name, std::ios::binary);\n";
+	output += "\tfile_out.write((char const*)header.data(), header.size());\n";
+	output += "\tfor(auto& s : sections)\n";
+	output += "\t\tfile_out.write((char const*)s.data(), s.size());\n";
+	output += "\tstatistics.save_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();\n";
+	output += "\tstatistics.load_seconds = " + project_prefix + "last_section_statistics.load_seconds;\n";
+	output += "\t" + project_prefix + "last_section_statistics = statistics;\n";
+	output += "}\n";
+
+	output += "struct " + project_prefix + "section_entry {\n";
+	output += "\tuint64_t offset = 0;\n";
+	output += "\tuint64_t length = 0;\n";
+	output += "\tuint64_t raw_length = 0;\n";
+	output += "\tuint8_t codec = 0;\n";
+	output += "\tbool found = false;\n";
+	output += "};\n";
+	// fills entries of the sections known to this schema, unknown ones are ignored
+	output += "bool " + project_prefix + "read_section_table(std::ifstream& file_in, " + project_prefix + "section_entry* table) {\n";
+	output += "\tfile_in.seekg(0, std::ios::end);\n";
+	output += "\tuint64_t const file_size = uint64_t(file_in.tellg());\n";
+	output += "\tfile_in.seekg(0, std::ios::beg);\n";
+	output += "\tauto get = [&](void* data, size_t sz) {\n";
+	output += "\t\treturn bool(file_in.read((char*)data, sz));\n";
+	output += "\t};\n";
+	output += "\tchar magic[4] = { };\n";
+	output += "\tuint32_t version = 0;\n";
+	output += "\tuint32_t count = 0;\n";
+	output += "\tif(!get(magic, 4) || std::memcmp(magic, \"DCLS\", 4) != 0 || !get(&version, 4) || (version != 1 && version != 2) || !get(&count, 4))\n";
+	output += "\t\treturn false;\n";
+	output += "\tstd::string section_name;\n";
+	output += "\tfor(uint32_t i = 0; i < count; ++i) {\n";
+	output += "\t\tuint32_t name_length = 0;\n";
+	output += "\t\tif(!get(&name_length, 4) || name_length > file_size)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tsection_name.resize(name_length);\n";
+	output += "\t\t" + project_prefix + "section_entry entry;\n";
+	output += "\t\tif(!get(section_name.data(), name_length) || !get(&entry.offset, 8) || !get(&entry.length, 8)\n";
+	output += "\t\t\t|| entry.offset > file_size || entry.length > file_size - entry.offset)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tentry.raw_length = entry.length;\n";
+	output += "\t\tif(version >= 2 && (!get(&entry.raw_length, 8) || !get(&entry.codec, 1) || entry.codec > 1))\n";
+	output += "\t\t\treturn false;\n";
+	// every input byte of a compressed section yields at most 255 output bytes, stored ones expand not at all
+	output += "\t\tif(entry.codec == 0 ? entry.raw_length != entry.length : entry.raw_length / 255 > entry.length)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tentry.found = true;\n";
+	output += "\t\tfor(int32_t j = 0; j < " + project_prefix + "section_count; ++j) {\n";
+	output += "\t\t\tif(section_name == " + project_prefix + "section_names[j])\n";
+	output += "\t\t\t\ttable[j] = entry;\n";
+	output += "\t\t}\n";
+	output += "\t}\n";
+	output += "\treturn true;\n";
+	output += "}\n";
+
+	output += "bool " + project_prefix + "load_sections_unchecked(char const* name, " + file.namspace + "::load_record const& selection, uint8_t const* mask) {\n";
+	output += "\tauto const start_time = std::chrono::steady_clock::now();\n";
+	output += "\tstd::ifstream file_in(name, std::ios::binary);\n";
+	output += "\tif(!file_in.is_open())\n";
+	output += "\t\treturn false;\n";
+	output += "\t" + project_prefix + "section_entry table[" + project_prefix + "section_count];\n";
+	output += "\tif(!" + project_prefix + "read_section_table(file_in, table))\n";
+	output += "\t\treturn false;\n";
+	output += "\tstd::vector<std::byte> contents[" + project_prefix + "section_count];\n";
+	output += "\tfor(int32_t i = 0; i < " + project_prefix + "section_count; ++i) {\n";
+	output += "\t\tif(!table[i].found || (mask && !mask[i]))\n";
+	output += "\t\t\tcontinue;\n";
+	output += "\t\tcontents[i].resize(size_t(table[i].length));\n";
+	output += "\t\tfile_in.seekg(std::streamoff(table[i].offset), std::ios::beg);\n";
+	output += "\t\tif(!file_in.read((char*)contents[i].data(), contents[i].size()))\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t}\n";
+	output += "\tstd::atomic<bool> decoded{ true };\n";
+	output += "\t" + project_prefix + "run_tasks(" + project_prefix + "section_count, [&](int32_t i) {\n";
+	output += "\t\tif(table[i].codec != 1 || contents[i].empty())\n";
+	output += "\t\t\treturn;\n";
+	output += "\t\tstd::vector<std::byte> raw(size_t(table[i].raw_length));\n";
+	output += "\t\tif(!" + project_prefix + "lz_decompress(contents[i].data(), contents[i].size(), raw.data(), raw.size()))\n";
+	output += "\t\t\tdecoded = false;\n";
+	output += "\t\tcontents[i] = std::move(raw);\n";
+	output += "\t});\n";
+	output += "\tif(!decoded)\n";
+	output += "\t\treturn false;\n";
+	output += "\t" + project_prefix + "run_tasks(" + project_prefix + "section_group_count, [&](int32_t group) {\n";
+	output += "\t\tfor(auto i : " + project_prefix + "section_load_order) {\n";
+	output += "\t\t\tif(" + project_prefix + "section_group_of[i] != group || !table[i].found || (mask && !mask[i]))\n";
+	output += "\t\t\t\tcontinue;\n";
+	output += "\t\t\t" + file.namspace + "::load_record loaded;\n";
+	output += "\t\t\tauto section_selection = " + project_prefix + "section_record(selection, i);\n";
+	output += "\t\t\tstd::byte const* ptr = contents[i].data();\n";
+	output += "\t\t\t" + ctx.game_state + "deserialize(ptr, ptr + contents[i].size(), loaded, section_selection);\n";
+	output += "\t\t}\n";
+	output += "\t});\n";
+	output += "\t" + project_prefix + "last_section_statistics.load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();\n";
+	output += "\treturn true;\n";
+	output += "}\n";
+	// mask has one entry per section (see section_index); sections left out are skipped over, not read.
+	// Failures, including allocations or a container that throws on a damaged section, end in false
+	// rather than crossing the C boundary
+	output += "bool " + project_prefix + "load_sections(char const* name, " + file.namspace + "::load_record const& selection, uint8_t const* mask) {\n";
+	output += "\ttry {\n";
+	output += "\t\treturn " + project_prefix + "load_sections_unchecked(name, selection, mask);\n";
+	output += "\t} catch(...) {\n";
+	output += "\t\treturn false;\n";
+	output += "\t}\n";
+	output += "}\n";
+
+	return output;
+}
+
+
+enum class column_encoding {
+	none, bit, integer, floating, handle
+};
+
+// scalar columns which can be carried by replication snapshots
+column_encoding classify_column(generation_context const& ctx, property_def const& p) {
+	if(p.is_derived)
+		return column_encoding::none;
+	if(p.type == property_type::bitfield)
+		return column_encoding::bit;
+	if(p.type != property_type::vectorizable && p.type != property_type::other)
+		return column_encoding::none;
+	auto normalized = normalize_type(p.data_type, ctx.made_types);
+	if(normalized.normalized == lua_type_match::handle_to_integer)
+		return column_encoding::handle;
+	if(normalized.normalized != lua_type_match::fat_float)
+		return column_encoding::none;
+	if(p.data_type == "float" || p.data_type == "double")
+		return column_encoding::floating;
+	return column_encoding::integer;
+}
+
+std::string make_identifier(std::string const& in) {
+	std::string result = in;
+	for(auto& c : result) {
+		if(!std::isalnum(uint8_t(c)))
+			c = '_';
+	}
+	return result;
+}
+
+// tags that switch on generator features rather than naming a replication channel
+bool is_feature_tag(std::string const& t) {
+	return t == "lua_index" || t == "lua_events";
+}
+
+// every tag carried by an object or a property, in order of first appearance
+
+std::vector<std::string> replication_tags(file_def const& file) {
+	std::vector<std::string> result;
+	auto add = [&](std::string const& t) {
+		if(!is_feature_tag(t) && std::find(result.begin(), result.end(), t) == result.end())
+			result.push_back(t);
+	};
+	for(auto& ob : file.relationship_objects) {
+		for(auto& t : ob.obj_tags)
+			add(t);
+		for(auto& p : ob.properties) {
+			for(auto& t : p.property_tags)
+				add(t);
+		}
+	}
+	return result;
+}
+
+struct replicated_column {
+	property_def const* prop = nullptr;
+	column_encoding encoding = column_encoding::none;
+	std::string code; // uint64_t code of the value at row `i`
+	std::string apply; // statement storing `code` into row `i`
+	std::string width; // bytes per code, 0 for varint
+};
+
+std::vector<replicated_column> replicated_columns(generation_context const& ctx, file_def& file, std::string const& project_prefix, relationship_object_def const& ob, std::string const& tag) {
+	std::vector<replicated_column> result;
+	bool const whole_object = std::find(ob.obj_tags.begin(), ob.obj_tags.end(), tag) != ob.obj_tags.end();
+	auto const id = convert_raw_to_id(file, ob.name, "i");
+	for(auto& p : ob.properties) {
+		if(!whole_object && std::find(p.property_tags.begin(), p.property_tags.end(), tag) == p.property_tags.end())
+			continue;
+		replicated_column c;
+		c.prop = &p;
+		c.encoding = classify_column(ctx, p);
+		auto const get = ctx.game_state + ob.name + "_get_" + p.name + "(" + id + ")";
+		auto const set = ctx.game_state + ob.name + "_set_" + p.name + "(" + id + ", ";
+		c.width = "0";
+		switch(c.encoding) {
+			case column_encoding::none:
+				continue;
+			case column_encoding::bit:
+				c.code = "uint64_t(" + get + " ? 1 : 0)";
+				c.apply = set + "code != 0);";
+				break;
+			case column_encoding::integer:
+				c.code = project_prefix + "zigzag(int64_t(" + get + "))";
+				c.apply = set + "static_cast<" + p.data_type + ">(" + project_prefix + "unzigzag(code)));";
+				break;
+			case column_encoding::floating:
+				c.code = project_prefix + "real_code(" + get + ", quantum)";
+				c.apply = set + project_prefix + "real_value<" + p.data_type + ">(code, quantum));";
+				c.width = "(quantum > 0.0f ? 0 : sizeof(" + p.data_type + "))";
+				break;
+			case column_encoding::handle:
+				c.code = project_prefix + "zigzag(" + get + ".index())";
+				c.apply = set + convert_raw_to_id_from_id(file, p.data_type, "int32_t(" + project_prefix + "unzigzag(code))") + ");";
+				break;
+		}
+		result.push_back(c);
+	}
+	// rows of erasable objects travel with their liveness, as a leading column without a property
+	if(!result.empty() && !ob.is_relationship && ob.store_type == storage_type::erasable) {
+		replicated_column c;
+		c.encoding = column_encoding::bit;
+		c.code = "uint64_t(" + ctx.game_state + ob.name + "_is_valid(" + id + ") ? 1 : 0)";
+		c.apply = "validity[i] = uint8_t(code != 0);";
+		c.width = "0";
+		result.insert(result.begin(), c);
+	}
+	return result;
+}
+
+bool has_validity_column(std::vector<replicated_column> const& columns) {
+	return !columns.empty() && columns[0].prop == nullptr;
+}
+
+// rejects row counts that the object could not hold or that exceed the limit set by the caller
+std::string replication_count_check(std::string const& project_prefix, relationship_object_def const& ob) {
+	auto result = "count > uint64_t(" + project_prefix + "replication_row_limit)";
+	if(!ob.is_expandable)
+		result += " || count > " + std::to_string(ob.size);
+	return result;
+}
+
+std::string restore_validity(std::string const& project_prefix, relationship_object_def const& ob) {
+	std::string output;
+	output += "\t\tif(!" + project_prefix + ob.name + "_restore_validity(validity))\n";
+	output += "\t\t\treturn false;\n";
+	return output;
+}
+
+// the local liveness of every row, to be overwritten by the received validity column
+std::string begin_validity(generation_context const& ctx, file_def& file, relationship_object_def const& ob) {
+	std::string output;
+	output += "\t\tstd::vector<uint8_t> validity(size);\n";
+	output += "\t\tfor(uint32_t i = 0; i < size; ++i)\n";
+	output += "\t\t\tvalidity[i] = uint8_t(" + ctx.game_state + ob.name + "_is_valid(" + convert_raw_to_id(file, ob.name, "i") + ") ? 1 : 0);\n";
+	return output;
+}
+
+// compact snapshots of the columns carrying a tag:
+// { float quantum } then, for every object with tagged columns, { varint row count } and one block per column
+// holding the code of every row: bitfields packed 8 rows to a byte, other columns as varints, except floats
+// which are stored raw when quantum is 0 and otherwise as the zigzagged count of quantum steps
+void make_replication_snapshots(generation_context const& ctx, file_def& file, std::string const& project_prefix, std::string& output, std::string& header_output) {
+	auto const tags = replication_tags(file);
+	if(tags.empty())
+		return;
+
+	output += "inline uint64_t " + project_prefix + "zigzag(int64_t v) {\n";
+	output += "\treturn (uint64_t(v) << 1) ^ uint64_t(v >> 63);\n";
+	output += "}\n";
+	output += "inline int64_t " + project_prefix + "unzigzag(uint64_t v) {\n";
+	output += "\treturn int64_t(v >> 1) ^ -int64_t(v & 1);\n";
+	output += "}\n";
+	output += "template<typename T>\n";
+	output += "uint64_t " + project_prefix + "real_code(T v, float quantum) {\n";
+	output += "\tif(quantum > 0.0f)\n";
+	output += "\t\treturn " + project_prefix + "zigzag(std::llround(double(v) / double(quantum)));\n";
+	output += "\tuint64_t code = 0;\n";
+	output += "\tstd::memcpy(&code, &v, sizeof(T));\n";
+	output += "\treturn code;\n";
+	output += "}\n";
+	output += "template<typename T>\n";
+	output += "T " + project_prefix + "real_value(uint64_t code, float quantum) {\n";
+	output += "\tif(quantum > 0.0f)\n";
+	output += "\t\treturn T(double(" + project_prefix + "unzigzag(code)) * double(quantum));\n";
+	output += "\tT v;\n";
+	output += "\tstd::memcpy(&v, &code, sizeof(T));\n";
+	output += "\treturn v;\n";
+	output += "}\n";
+	output += "inline void " + project_prefix + "put_code(std::vector<uint8_t>& out, uint64_t code, size_t width) {\n";
+	output += "\tif(width != 0) {\n";
+	output += "\t\tfor(size_t k = 0; k < width; ++k)\n";
+	output += "\t\t\tout.push_back(uint8_t(code >> (8 * k)));\n";
+	output += "\t\treturn;\n";
+	output += "\t}\n";
+	output += "\twhile(code >= 0x80) {\n";
+	output += "\t\tout.push_back(uint8_t(code | 0x80));\n";
+	output += "\t\tcode >>= 7;\n";
+	output += "\t}\n";
+	output += "\tout.push_back(uint8_t(code));\n";
+	output += "}\n";
+	output += "inline bool " + project_prefix + "get_code(uint8_t const*& p, uint8_t const* end, uint64_t& code, size_t width) {\n";
+	output += "\tcode = 0;\n";
+	output += "\tif(width != 0) {\n";
+	output += "\t\tif(size_t(end - p) < width)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tfor(size_t k = 0; k < width; ++k)\n";
+	output += "\t\t\tcode |= uint64_t(*p++) << (8 * k);\n";
+	output += "\t\treturn true;\n";
+	output += "\t}\n";
+	output += "\tfor(int32_t shift = 0; p < end && shift < 64; shift += 7) {\n";
+	output += "\t\tuint8_t const b = *p++;\n";
+	output += "\t\tcode |= uint64_t(b & 0x7F) << shift;\n";
+	output += "\t\tif((b & 0x80) == 0)\n";
+	output += "\t\t\treturn true;\n";
+	output += "\t}\n";
+	output += "\treturn false;\n";
+	output += "}\n";
+
+	header_output += "DCON_LUADLL_API void " + project_prefix + "set_replication_row_limit(uint32_t limit); \n";
+	output += "static uint32_t " + project_prefix + "replication_row_limit = 1u << 20;\n";
+	output += "void " + project_prefix + "set_replication_row_limit(uint32_t limit) { \n";
+	output += "\t" + project_prefix + "replication_row_limit = limit;\n";
+	output += "}\n";
+
+	// the container hands out free rows in its own order, so rows are created until every missing one
+	// has come up and the ones that should stay free are deleted again
+	for(auto& ob : file.relationship_objects) {
+		bool replicated = false;
+		for(auto& tag : tags)
+			replicated = replicated || has_validity_column(replicated_columns(ctx, file, project_prefix, ob, tag));
+		if(!replicated)
+			continue;
+		output += "bool " + project_prefix + ob.name + "_restore_validity(std::vector<uint8_t> const& validity) {\n";
+		output += "\tuint32_t const size = uint32_t(validity.size());\n";
+		output += "\tuint32_t missing = 0;\n";
+		output += "\tfor(uint32_t i = 0; i < size; ++i) {\n";
+		output += "\t\tbool const live = " + ctx.game_state + ob.name + "_is_valid(" + convert_raw_to_id(file, ob.name, "i") + ");\n";
+		output += "\t\tif(live && !validity[i])\n";
+		output += "\t\t\t" + project_prefix + "delete_" + ob.name + "(int32_t(i));\n";
+		output += "\t\telse if(!live && validity[i])\n";
+		output += "\t\t\t++missing;\n";
+		output += "\t}\n";
+		output += "\tstd::vector<int32_t> unwanted;\n";
+		output += "\twhile(missing > 0) {\n";
+		output += "\t\tint32_t const j = " + project_prefix + "create_" + ob.name + "();\n";
+		output += "\t\tif(j < 0)\n";
+		output += "\t\t\tbreak;\n";
+		output += "\t\tif(uint32_t(j) < size && validity[j])\n";
+		output += "\t\t\t--missing;\n";
+		output += "\t\telse\n";
+		output += "\t\t\tunwanted.push_back(j);\n";
+		output += "\t\tif(uint32_t(j) >= size)\n";
+		output += "\t\t\tbreak;\n";
+		output += "\t}\n";
+		output += "\tfor(auto j : unwanted)\n";
+		output += "\t\t" + project_prefix + "delete_" + ob.name + "(j);\n";
+		output += "\tif(" + ctx.game_state + ob.name + "_size() > size)\n";
+		output += "\t\t" + ctx.game_state + ob.name + "_resize(size);\n";
+		output += "\treturn missing == 0;\n";
+		output += "}\n";
+	}
+
+	for(auto& tag : tags) {
+		auto const tag_name = make_identifier(tag);
+		auto const buffer = project_prefix + tag_name + "_snapshot_buffer";
+
+		// the returned buffer stays valid until the next call
+		header_output += "DCON_LUADLL_API uint8_t const* " + project_prefix + "encode_" + tag_name + "_snapshot(float quantum, size_t* size); \n";
+		output += "static std::vector<uint8_t> " + buffer + ";\n";
+		output += "uint8_t const* " + project_prefix + "encode_" + tag_name + "_snapshot(float quantum, size_t* size) { \n";
+		output += "\tauto& out = " + buffer + ";\n";
+		output += "\tout.clear();\n";
+		output += "\t" + project_prefix + "put_code(out, " + project_prefix + "real_code(quantum, 0.0f), sizeof(float));\n";
+		for(auto& ob : file.relationship_objects) {
+			auto columns = replicated_columns(ctx, file, project_prefix, ob, tag);
+			if(columns.empty())
+				continue;
+			output += "\t{\n";
+			output += "\t\tuint32_t const count = " + ctx.game_state + ob.name + "_size();\n";
+			output += "\t\t" + project_prefix + "put_code(out, count, 0);\n";
+			for(auto& c : columns) {
+				if(c.encoding == column_encoding::bit) {
+					output += "\t\tfor(uint32_t first = 0; first < count; first += 8) {\n";
+					output += "\t\t\tuint8_t bits = 0;\n";
+					output += "\t\t\tfor(uint32_t i = first; i < first + 8 && i < count; ++i)\n";
+					output += "\t\t\t\tbits |= uint8_t(" + c.code + " << (i - first));\n";
+					output += "\t\t\tout.push_back(bits);\n";
+					output += "\t\t}\n";
+				} else {
+					output += "\t\tfor(uint32_t i = 0; i < count; ++i)\n";
+					output += "\t\t\t" + project_prefix + "put_code(out, " + c.code + ", " + c.width + ");\n";
+				}
+			}
+			output += "\t}\n";
+		}
+		output += "\t*size = out.size();\n";
+		output += "\treturn out.data();\n";
+		output += "}\n";
+
+		header_output += "DCON_LUADLL_API bool " + project_prefix + "decode_" + tag_name + "_snapshot(uint8_t const* data, size_t size); \n";
+		output += "bool " + project_prefix + "decode_" + tag_name + "_snapshot(uint8_t const* data, size_t size) { \n";
+		if(has_native_indexes(ctx, file))
+			output += "\t" + project_prefix + "index_guard const rebuild_guard;\n";
+		output += "\tuint8_t const* p = data;\n";
+		output += "\tuint8_t const* const end = data + size;\n";
+		output += "\tuint64_t code = 0;\n";
+		output += "\tif(!" + project_prefix + "get_code(p, end, code, sizeof(float)))\n";
+		output += "\t\treturn false;\n";
+		bool has_floating = false;
+		for(auto& ob : file.relationship_objects) {
+			for(auto& c : replicated_columns(ctx, file, project_prefix, ob, tag))
+				has_floating = has_floating || c.encoding == column_encoding::floating;
+		}
+		if(has_floating)
+			output += "\tfloat const quantum = " + project_prefix + "real_value<float>(code, 0.0f);\n";
+		for(auto& ob : file.relationship_objects) {
+			auto columns = replicated_columns(ctx, file, project_prefix, ob, tag);
+			if(columns.empty())
+				continue;
+			output += "\t{\n";
+			output += "\t\tuint64_t count = 0;\n";
+			output += "\t\tif(!" + project_prefix + "get_code(p, end, count, 0) || count > uint64_t(end - p) * 8 || " + replication_count_check(project_prefix, ob) + ")\n";
+			output += "\t\t\treturn false;\n";
+			if(!ob.is_relationship) {
+				output += "\t\tif(count != " + ctx.game_state + ob.name + "_size())\n";
+				output += "\t\t\t" + ctx.game_state + ob.name + "_resize(uint32_t(count));\n";
+			}
+			output += "\t\tuint32_t const size = " + ctx.game_state + ob.name + "_size();\n";
+			if(has_validity_column(columns))
+				output += begin_validity(ctx, file, ob);
+			for(auto& c : columns) {
+				if(c.encoding == column_encoding::bit) {
+					output += "\t\tif(uint64_t(end - p) < (count + 7) / 8)\n";
+					output += "\t\t\treturn false;\n";
+					output += "\t\tfor(uint32_t i = 0; i < count; ++i) {\n";
+					output += "\t\t\tcode = (p[i / 8] >> (i % 8)) & 1;\n";
+					output += "\t\t\tif(i < size)\n";
+					output += "\t\t\t\t" + c.apply + "\n";
+					output += "\t\t}\n";
+					output += "\t\tp += (count + 7) / 8;\n";
+				} else {
+					output += "\t\tfor(uint32_t i = 0; i < count; ++i) {\n";
+					output += "\t\t\tif(!" + project_prefix + "get_code(p, end, code, " + c.width + "))\n";
+					output += "\t\t\t\treturn false;\n";
+					output += "\t\t\tif(i < size)\n";
+					output += "\t\t\t\t" + c.apply + "\n";
+					output += "\t\t}\n";
+				}
+				// rows are revived before their values arrive, since creating a row clears it
+				if(c.prop == nullptr)
+					output += restore_validity(project_prefix, ob);
+			}
+			output += "\t}\n";
+		}
+		output += "\treturn p == end;\n";
+		output += "}\n";
+	}
+}
+
+// deltas between the state and a previous snapshot of the same tag:
+// { float quantum } then, for every object of the snapshot, { varint row count } and one run list per column;
+// a run list is a sequence of { varint unchanged rows, varint changed rows, codes of the changed rows }
+// closed by a run of zero changed rows, with the codes of bitfield runs packed 8 rows to a byte
+void make_replication_deltas(generation_context const& ctx, file_def& file, std::string const& project_prefix, std::string& output, std::string& header_output) {
+	auto const tags = replication_tags(file);
+	if(tags.empty())
+		return;
+
+	output += "inline bool " + project_prefix + "get_column(uint8_t const*& p, uint8_t const* end, uint64_t count, size_t width, bool bits, std::vector<uint64_t>& codes) {\n";
+	output += "\tcodes.resize(size_t(count));\n";
+	output += "\tif(bits) {\n";
+	output += "\t\tif(uint64_t(end - p) < (count + 7) / 8)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tfor(uint64_t i = 0; i < count; ++i)\n";
+	output += "\t\t\tcodes[i] = (p[i / 8] >> (i % 8)) & 1;\n";
+	output += "\t\tp += (count + 7) / 8;\n";
+	output += "\t\treturn true;\n";
+	output += "\t}\n";
+	output += "\tfor(auto& code : codes) {\n";
+	output += "\t\tif(!" + project_prefix + "get_code(p, end, code, width))\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t}\n";
+	output += "\treturn true;\n";
+	output += "}\n";
+	output += "inline void " + project_prefix + "put_runs(std::vector<uint8_t>& out, std::vector<uint64_t> const& previous, std::vector<uint64_t> const& current, size_t width, bool bits) {\n";
+	output += "\tauto changed = [&](size_t i) {\n";
+	output += "\t\treturn i >= previous.size() || previous[i] != current[i];\n";
+	output += "\t};\n";
+	output += "\tsize_t last_end = 0;\n";
+	output += "\tfor(size_t i = 0; i < current.size(); ) {\n";
+	output += "\t\tif(!changed(i)) {\n";
+	output += "\t\t\t++i;\n";
+	output += "\t\t\tcontinue;\n";
+	output += "\t\t}\n";
+	output += "\t\tsize_t run_end = i + 1;\n";
+	output += "\t\twhile(run_end < current.size() && changed(run_end))\n";
+	output += "\t\t\t++run_end;\n";
+	output += "\t\t" + project_prefix + "put_code(out, i - last_end, 0);\n";
+	output += "\t\t" + project_prefix + "put_code(out, run_end - i, 0);\n";
+	output += "\t\tif(bits) {\n";
+	output += "\t\t\tfor(size_t first = i; first < run_end; first += 8) {\n";
+	output += "\t\t\t\tuint8_t packed = 0;\n";
+	output += "\t\t\t\tfor(size_t k = first; k < first + 8 && k < run_end; ++k)\n";
+	output += "\t\t\t\t\tpacked |= uint8_t(current[k] << (k - first));\n";
+	output += "\t\t\t\tout.push_back(packed);\n";
+	output += "\t\t\t}\n";
+	output += "\t\t} else {\n";
+	output += "\t\t\tfor(size_t k = i; k < run_end; ++k)\n";
+	output += "\t\t\t\t" + project_prefix + "put_code(out, current[k], width);\n";
+	output += "\t\t}\n";
+	output += "\t\tlast_end = i = run_end;\n";
+	output += "\t}\n";
+	output += "\t" + project_prefix + "put_code(out, 0, 0);\n";
+	output += "\t" + project_prefix + "put_code(out, 0, 0);\n";
+	output += "}\n";
+	output += "template<typename F>\n";
+	output += "bool " + project_prefix + "get_runs(uint8_t const*& p, uint8_t const* end, uint64_t count, size_t width, bool bits, F const& apply) {\n";
+	output += "\tfor(uint64_t row = 0; ; ) {\n";
+	output += "\t\tuint64_t gap = 0;\n";
+	output += "\t\tuint64_t length = 0;\n";
+	output += "\t\tif(!" + project_prefix + "get_code(p, end, gap, 0) || !" + project_prefix + "get_code(p, end, length, 0))\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\tif(length == 0)\n";
+	output += "\t\t\treturn true;\n";
+	output += "\t\tif(gap > count - row || length > count - row - gap)\n";
+	output += "\t\t\treturn false;\n";
+	output += "\t\trow += gap;\n";
+	output += "\t\tif(bits) {\n";
+	output += "\t\t\tif(uint64_t(end - p) < (length + 7) / 8)\n";
+	output += "\t\t\t\treturn false;\n";
+	output += "\t\t\tfor(uint64_t k = 0; k < length; ++k)\n";
+	output += "\t\t\t\tapply(row + k, uint64_t((p[k / 8] >> (k % 8)) & 1));\n";
+	output += "\t\t\tp += (length + 7) / 8;\n";
+	output += "\t\t} else {\n";
+	output += "\t\t\tfor(uint64_t k = 0; k < length; ++k) {\n";
+	output += "\t\t\t\tuint64_t code = 0;\n";
+	output += "\t\t\t\tif(!" + project_prefix + "get_code(p, end, code, width))\n";
+	output += "\t\t\t\t\treturn false;\n";
+	output += "\t\t\t\tapply(row + k, code);\n";
+	output += "\t\t\t}\n";
+	output += "\t\t}\n";
+	output += "\t\trow += length;\n";
+	output += "\t}\n";
+	output += "}\n";
+
+	for(auto& tag : tags) {
+		auto const tag_name = make_identifier(tag);
+		auto const buffer = project_prefix + tag_name + "_delta_buffer";
+
+		bool has_floating = false;
+		for(auto& ob : file.relationship_objects) {
+			for(auto& c : replicated_columns(ctx, file, project_prefix, ob, tag))
+				has_floating = has_floating || c.encoding == column_encoding::floating;
+		}
+
+		// previous must be a snapshot of the same tag; the returned buffer stays valid until the next call
+		header_output += "DCON_LUADLL_API uint8_t const* " + project_prefix + "encode_" + tag_name + "_delta(uint8_t const* previous, size_t previous_size, size_t* size); \n";
+		output += "static std::vector<uint8_t> " + buffer + ";\n";
+		output += "uint8_t const* " + project_prefix + "encode_" + tag_name + "_delta(uint8_t const* previous, size_t previous_size, size_t* size) { \n";
+		output += "\tauto& out = " + buffer + ";\n";
+		output += "\tout.clear();\n";
+		output += "\t*size = 0;\n";
+		output += "\tuint8_t const* p = previous;\n";
+		output += "\tuint8_t const* const end = previous + previous_size;\n";
+		output += "\tuint64_t code = 0;\n";
+		output += "\tif(!" + project_prefix + "get_code(p, end, code, sizeof(float)))\n";
+		output += "\t\treturn nullptr;\n";
+		output += "\t" + project_prefix + "put_code(out, code, sizeof(float));\n";
+		if(has_floating)
+			output += "\tfloat const quantum = " + project_prefix + "real_value<float>(code, 0.0f);\n";
+		output += "\tstd::vector<uint64_t> previous_codes;\n";
+		output += "\tstd::vector<uint64_t> current_codes;\n";
+		for(auto& ob : file.relationship_objects) {
+			auto columns = replicated_columns(ctx, file, project_prefix, ob, tag);
+			if(columns.empty())
+				continue;
+			output += "\t{\n";
+			output += "\t\tuint64_t previous_count = 0;\n";
+			output += "\t\tif(!" + project_prefix + "get_code(p, end, previous_count, 0) || previous_count > uint64_t(end - p) * 8 || previous_count > uint64_t(" + project_prefix + "replication_row_limit))\n";
+			output += "\t\t\treturn nullptr;\n";
+			output += "\t\tuint32_t const count = " + ctx.game_state + ob.name + "_size();\n";
+			output += "\t\t" + project_prefix + "put_code(out, count, 0);\n";
+			output += "\t\tcurrent_codes.resize(count);\n";
+			for(auto& c : columns) {
+				auto const bits = c.encoding == column_encoding::bit ? "true" : "false";
+				output += "\t\tif(!" + project_prefix + "get_column(p, end, previous_count, " + c.width + ", " + bits + ", previous_codes))\n";
+				output += "\t\t\treturn nullptr;\n";
+				output += "\t\tfor(uint32_t i = 0; i < count; ++i)\n";
+				output += "\t\t\tcurrent_codes[i] = " + c.code + ";\n";
+				output += "\t\t" + project_prefix + "put_runs(out, previous_codes, current_codes, " + c.width + ", " + bits + ");\n";
+			}
+			output += "\t}\n";
+		}
+		output += "\t*size = out.size();\n";
+		output += "\treturn out.data();\n";
+		output += "}\n";
+
+		header_output += "DCON_LUADLL_API bool " + project_prefix + "apply_" + tag_name + "_delta(uint8_t const* data, size_t size); \n";
+		output += "bool " + project_prefix + "apply_" + tag_name + "_delta(uint8_t const* data, size_t size) { \n";
+		if(has_native_indexes(ctx, file))
+			output += "\t" + project_prefix + "index_guard const rebuild_guard;\n";
+		output += "\tuint8_t const* p = data;\n";
+		output += "\tuint8_t const* const end = data + size;\n";
+		output += "\tuint64_t code = 0;\n";
+		output += "\tif(!" + project_prefix + "get_code(p, end, code, sizeof(float)))\n";
+		output += "\t\treturn false;\n";
+		if(has_floating)
+			output += "\tfloat const quantum = " + project_prefix + "real_value<float>(code, 0.0f);\n";
+		for(auto& ob : file.relationship_objects) {
+			auto columns = replicated_columns(ctx, file, project_prefix, ob, tag);
+			if(columns.empty())
+				continue;
+			output += "\t{\n";
+			output += "\t\tuint64_t count = 0;\n";
+			output += "\t\tif(!" + project_prefix + "get_code(p, end, count, 0) || " + replication_count_check(project_prefix, ob) + ")\n";
+			output += "\t\t\treturn false;\n";
+			if(!ob.is_relationship) {
+				output += "\t\tif(count != " + ctx.game_state + ob.name + "_size())\n";
+				output += "\t\t\t" + ctx.game_state + ob.name + "_resize(uint32_t(count));\n";
+			}
+			output += "\t\tuint32_t const size = " + ctx.game_state + ob.name + "_size();\n";
+			if(has_validity_column(columns))
+				output += begin_validity(ctx, file, ob);
+			for(auto& c : columns) {
+				auto const bits = c.encoding == column_encoding::bit ? "true" : "false";
+				output += "\t\tif(!" + project_prefix + "get_runs(p, end, count, " + c.width + ", " + bits + ", [&](uint64_t row, uint64_t code) {\n";
+				output += "\t\t\tuint32_t const i = uint32_t(row);\n";
+				output += "\t\t\tif(i < size)\n";
+				output += "\t\t\t\t" + c.apply + "\n";
+				output += "\t\t}))\n";
+				output += "\t\t\treturn false;\n";
+				if(c.prop == nullptr)
+					output += restore_validity(project_prefix, ob);
+			}
+			output += "\t}\n";
+		}
+		output += "\treturn p == end;\n";
+		output += "}\n";
+	}
+}
 
-	game_state = argv[2];
+generation_result generate_bindings(generation_options const& options, std::string const& definition) {
+	return generate_bindings(options, definition.c_str(), definition.c_str() + definition.length());
+}
+
+generation_result generate_bindings(generation_options const& options, char const* definition_start, char const* definition_end) {
+	generation_context ctx;
+	generation_result result;
+
+	const std::string project_name = options.project_name;
+	const std::string project_prefix = project_name + "_";
 
-	std::fstream input_file;
-	std::string input_file_name(argv[3]);
-	input_file.open(argv[3], std::ios::in);
+	ctx.game_state = options.data_container;
 
-	const std::string dll_source_name = argv[4];
-	const std::string dll_header_name = argv[5];
-	const std::string lua_folder = argv[6];
+	const std::string dll_source_name = options.source_name;
+	const std::string dll_header_name = options.header_name;
+	const std::string lua_folder = options.lua_folder;
 	const std::string lua_dcon_path = lua_folder + "/dcon_generated";
 	const std::string lua_manager_name = lua_folder + "/" + "manager.lua";
 
+	// split objects get their own translation units next to the shared one
+	bool const split_objects = options.split_objects;
+	const std::string dll_source_stem = [&]() {
+		auto ext_pos = dll_source_name.find_last_of('.');
+		auto sep_pos = dll_source_name.find_last_of("\\/");
+		if(ext_pos == std::string::npos || (sep_pos != std::string::npos && ext_pos < sep_pos))
+			return dll_source_name;
+		return dll_source_name.substr(0, ext_pos);
+	}();
+	// included by every unit when objects are split, so that each of them compiles on its own
+	const std::string shared_header_name = dll_source_stem + "_shared.hpp";
+	const std::string shared_include_name = [&]() {
+		auto sep_pos = shared_header_name.find_last_of("\\/");
+		return sep_pos == std::string::npos ? shared_header_name : shared_header_name.substr(sep_pos + 1);
+	}();
+
 
 	const std::string base_include_name = [&]() {
 		auto sep_pos = dll_header_name.find_last_of('\\');
@@ -619,24 +2647,13 @@ int main(int argc, char *argv[]) {
 		}
 	}();
 
-	error_record err(input_file_name);
-
-	if(!input_file.is_open()) {
-		err.add(row_col_pair{ 0, 0}, 1000, "Could not open input file");
-		std::cout << err.accumulated;
-		return -1;
-	}
-
-	std::string file_contents((std::istreambuf_iterator<char>(input_file)), std::istreambuf_iterator<char>());
-
-	file_def parsed_file = parse_file(file_contents.c_str(), file_contents.c_str() + file_contents.length(), err);
+	error_record err(options.definition_name);
 
-	input_file.close();
+	file_def parsed_file = parse_file(definition_start, definition_end, err);
 
 	if(err.accumulated.length() > 0) {
-		error_to_file(dll_header_name);
-		std::cout << err.accumulated;
-		return -1;
+		result.errors = err.accumulated;
+		return result;
 	}
 
 	// patchup relationship pointers & other information
@@ -649,9 +2666,8 @@ int main(int argc, char *argv[]) {
 					relobj.related_to = linked_object;
 				} else {
 					err.add(row_col_pair{ 0, 0}, 1001, std::string("Could not find object named: ") + relobj.type_name + " in relationship: " + r.name);
-					error_to_file(dll_header_name);
-					std::cout << err.accumulated;
-					return -1;
+					result.errors = err.accumulated;
+					return result;
 				}
 				if(relobj.index == index_type::at_most_one && !relobj.is_optional && relobj.multiplicity == 1) {
 					r.primary_key.points_to = better_primary_key(r.primary_key.points_to, relobj.related_to);
@@ -662,9 +2678,8 @@ int main(int argc, char *argv[]) {
 				if(relobj.multiplicity > 1 && relobj.index == index_type::many && relobj.ltype == list_type::list) {
 					err.add(row_col_pair{ 0, 0}, 1002, std::string("Unsupported combination of list type storage with multiplicity > 1 in link ")
 						+ relobj.property_name + " in relationship: " + r.name);
-					error_to_file(dll_header_name);
-					std::cout << err.accumulated;
-					return -1;
+					result.errors = err.accumulated;
+					return result;
 				}
 
 				if(relobj.multiplicity > 1 && relobj.index == index_type::at_most_one) {
@@ -676,9 +2691,8 @@ int main(int argc, char *argv[]) {
 
 			if(r.indexed_objects.size() == 0) {
 				err.add(row_col_pair{ 0, 0}, 1003, std::string("Relationship: ") + r.name + " is between too few objects");
-				error_to_file(dll_header_name);
-				std::cout << err.accumulated;
-				return -1;
+				result.errors = err.accumulated;
+				return result;
 			}
 
 
@@ -694,9 +2708,8 @@ int main(int argc, char *argv[]) {
 				}
 				if(!pk_forced) {
 					err.add(row_col_pair{ 0, 0}, 1004, std::string("Was unable to use ") + r.force_pk + std::string(" as a primary key for relationship: ") + r.name);
-					error_to_file(dll_header_name);
-					std::cout << err.accumulated;
-					return -1;
+					result.errors = err.accumulated;
+					return result;
 				}
 			}
 
@@ -719,9 +2732,8 @@ int main(int argc, char *argv[]) {
 				if(r.store_type != storage_type::erasable && r.store_type != storage_type::compactable) {
 					err.add(row_col_pair{ 0, 0}, 1005, std::string("Relationship ") + r.name +
 						" has no primary key, and thus must have either a compactable or erasable storage type to provide a delete function.");
-					error_to_file(dll_header_name);
-					std::cout << err.accumulated;
-					return -1;
+					result.errors = err.accumulated;
+					return result;
 				}
 			}
 
@@ -783,9 +2795,8 @@ int main(int argc, char *argv[]) {
 				if(k.object_type.length() == 0) {
 					err.add(row_col_pair{ 0, 0}, 1006, std::string("Indexed link ") + k.property_name + " in composite key " + cc.name +
 						" in relationship " + ob.name + " does not refer to a link in the relationship.");
-					error_to_file(dll_header_name);
-					std::cout << err.accumulated;
-					return -1;
+					result.errors = err.accumulated;
+					return result;
 				}
 
 				k.bit_position = bits_so_far;
@@ -817,10 +2828,37 @@ int main(int argc, char *argv[]) {
 	for(auto& q : parsed_file.unprepared_queries) {
 		parsed_file.prepared_queries.push_back(make_prepared_definition(parsed_file, q, err));
 	}
+
+	std::vector<std::string> kernel_bodies;
+	for(auto& k : parsed_file.kernels) {
+		std::string error;
+		kernel_bodies.emplace_back();
+		if(!compile_kernel(ctx, parsed_file, k, kernel_bodies.back(), error))
+			err.add(calculate_line_from_position(definition_start, definition_start + k.position), 1007, "In kernel " + k.name + ": " + error);
+	}
+	// the shared header of split objects declares the container object, so it must be a plain variable
+	auto const container = container_reference(ctx);
+	auto const container_is_pointer = container.size() > 2 && container.front() == '(';
+	auto const container_variable = container_is_pointer ? container.substr(2, container.size() - 3) : container;
+	if(split_objects) {
+		if(options.container_header.empty())
+			err.add(row_col_pair{ 0, 0 }, 1008, std::string("Splitting objects requires the header that declares the data container"));
+		bool plain = container_variable.size() > 0 && !std::isdigit(uint8_t(container_variable[0]));
+		for(auto c : container_variable)
+			plain = plain && (std::isalnum(uint8_t(c)) || c == '_');
+		if(!plain)
+			err.add(row_col_pair{ 0, 0 }, 1009, std::string("Splitting objects requires the container to be accessed through a variable, not: ") + ctx.game_state);
+	}
 	if(err.accumulated.length() > 0) {
-		error_to_file(dll_header_name);
-		std::cout << err.accumulated;
-		return -1;
+		result.errors = err.accumulated;
+		return result;
+	}
+
+	for(auto& ob : parsed_file.relationship_objects) {
+		ctx.made_types.insert(ob.name + "_id");
+	}
+	for(auto& mi : parsed_file.extra_ids) {
+		ctx.made_types.insert(mi.name);
 	}
 
 	// compose contents of generated file
@@ -831,30 +2869,73 @@ int main(int argc, char *argv[]) {
 	lua_manager += "-- GENERATED FILE: DO NOT EDIT --\n";
 
 
-	output += "//\n";
-	output += "// This file was automatically generated from: " + std::string(argv[3]) + "\n";
-	output += "// EDIT AT YOUR OWN RISK; all changes will be lost upon regeneration\n";
-	output += "// NOT SUITABLE FOR USE IN CRITICAL SOFTWARE WHERE LIVES OR LIVELIHOODS DEPEND ON THE CORRECT OPERATION\n";
-	output += "//\n";
-	output += "\n";
+	std::string banner;
+	banner += "//\n";
+	banner += "// This file was automatically generated from: " + options.definition_name + "\n";
+	banner += "// EDIT AT YOUR OWN RISK; all changes will be lost upon regeneration\n";
+	banner += "// NOT SUITABLE FOR USE IN CRITICAL SOFTWARE WHERE LIVES OR LIVELIHOODS DEPEND ON THE CORRECT OPERATION\n";
+	banner += "//\n";
+	banner += "\n";
 	output += "#define DCON_LUADLL_EXPORTS\n";
+	if(split_objects)
+		output += "#include \"" + options.container_header + "\"\n";
 	output += "#include \"" + base_include_name + "\"\n";
-	if(parsed_file.load_save_routines.size() > 0) {
-		output += "#include <fstream>\n";
-		output += "#include <filesystem>\n";
-		output += "#include <iostream>\n";
+	// every feature adds the headers it needs; each is included once, shared with the split units
+	std::set<std::string> includes;
+	if(parsed_file.load_save_routines.size() > 0)
+		includes.insert({ "fstream", "filesystem", "iostream", "iterator", "vector", "string", "cstring", "algorithm", "functional", "atomic", "thread", "chrono" });
+	if(parsed_file.relationship_objects.size() > 0)
+		includes.insert({ "vector", "functional", "atomic", "thread", "mutex", "condition_variable", "memory", "exception" });
+	if(parsed_file.globals.size() > 0)
+		includes.insert("type_traits");
+	if(has_native_indexes(ctx, parsed_file))
+		includes.insert({ "unordered_map", "vector", "cstring", "algorithm" });
+	if(replication_tags(parsed_file).size() > 0)
+		includes.insert({ "vector", "cstring", "cmath" });
+	for(auto& ob : parsed_file.relationship_objects) {
+		if(ob.swappable_list.size() > 0)
+			includes.insert("algorithm");
 	}
+	for(auto& header : includes)
+		output += "#include <" + header + ">\n";
+
+	// when objects are split, the includes, the container object and the helpers the units share
+	// are declared once in the shared header, which every unit, the main one included, starts with
+	std::string shared_header;
+	std::string object_source_prelude;
+	if(split_objects) {
+		shared_header += "#pragma once\n";
+		shared_header += "\n";
+		shared_header += banner;
+		shared_header += output;
+		shared_header += "\n";
+		shared_header += "extern " + parsed_file.namspace + "::data_container" + (container_is_pointer ? "* " : " ") + container_variable + ";\n";
+		shared_header += "extern void (*release_object_function)(int32_t);\n";
+		if(parsed_file.relationship_objects.size() > 0)
+			shared_header += "void " + project_prefix + "run_tasks(int32_t count, std::function<void(int32_t)> const& task);\n";
+		if(has_events(parsed_file))
+			shared_header += "void " + project_prefix + "push_event(int32_t kind, int32_t object, int32_t id, int32_t link, int32_t slot, int32_t value);\n";
+		if(has_native_indexes(ctx, parsed_file))
+			shared_header += "void " + project_prefix + "invalidate_indexes();\n";
+
+		output = "#include \"" + shared_include_name + "\"\n";
+		object_source_prelude = banner + output + "\n";
+	}
+	output = banner + output;
+	std::vector<std::string> object_sources;
 
 
 	header_output += "#pragma once\n";
 	header_output += "\n";
 	header_output += "//\n";
-	header_output += "// This file was automatically generated from: " + std::string(argv[3]) + "\n";
+	header_output += "// This file was automatically generated from: " + options.definition_name + "\n";
 	header_output += "// EDIT AT YOUR OWN RISK; all changes will be lost upon regeneration\n";
 	header_output += "// NOT SUITABLE FOR USE IN CRITICAL SOFTWARE WHERE LIVES OR LIVELIHOODS DEPEND ON THE CORRECT OPERATION\n";
 	header_output += "//\n";
 	header_output += "\n";
 	header_output += "#include <stdint.h>\n";
+	if(replication_tags(parsed_file).size() > 0)
+		header_output += "#include <stddef.h>\n";
 	header_output += "using lua_reference_type = int32_t;\n";
 	// header_output += "#include \"" + base_include_name + "\"\n";
 	header_output += "#ifdef _WIN32\n";
@@ -868,7 +2949,7 @@ int main(int argc, char *argv[]) {
 
 	//open new namespace
 	header_output += "\n";
-	// header_output += parsed_file.namspace + "::data_container game_state;\n";
+	// header_output += parsed_file.namspace + "::data_container ctx.game_state;\n";
 	header_output += "\n";
 
 	output += "\n";
@@ -883,20 +2964,39 @@ int main(int argc, char *argv[]) {
 	output += "\trelease_object_function = fn;\n";
 	output += "}\n";
 
-	for(auto& ob : parsed_file.relationship_objects) {
-		made_types.insert(ob.name + "_id");
+	if(parsed_file.relationship_objects.size() > 0) {
+		output += make_thread_pool(project_prefix);
+	}
+	if(has_events(parsed_file)) {
+		output += make_event_ring(project_prefix, header_output);
+	}
+	if(has_native_indexes(ctx, parsed_file)) {
+		output += "void " + project_prefix + "invalidate_indexes();\n";
 	}
 
 	std::string lua_ids_collection = "";
 
 	for(auto& mi : parsed_file.extra_ids) {
-		made_types.insert(mi.name);
 		lua_ids_collection += "---@class (exact)" + lua_id(mi.name) + " : table\n";
 		lua_ids_collection += "---@field _is_" + mi.name + "_id true\n\n";
 	}
 
 
-	for(auto& ob : parsed_file.relationship_objects) {
+	// objects only read the parsed file, so each one is generated on its own into private buffers,
+	// which are then stitched together in declaration order
+	struct object_output {
+		std::string source;
+		std::string header;
+		std::string lua_ids;
+		std::string lua;
+	};
+	std::vector<object_output> object_outputs(parsed_file.relationship_objects.size());
+
+	auto generate_object = [&](relationship_object_def& ob, object_output& buffers) {
+		// these hide the shared buffers for the rest of the object's generation
+		std::string& output = buffers.source;
+		std::string& header_output = buffers.header;
+		std::string& lua_ids_collection = buffers.lua_ids;
 
 		// std::string lua_meta = 	"--    GENERATED FILE: DO NOT EDIT     --\n";
 		// lua_meta += 		"-- PROVIDES TYPING FOR GENERATED CODE --\n";
@@ -937,7 +3037,7 @@ int main(int argc, char *argv[]) {
 
 		auto append_call = [&](function_call_information call) {
 			std::string head = generate_head(call);
-			std::string body = generate_body(parsed_file, call);
+			std::string body = generate_body(ctx, parsed_file, call);
 			header_output += "DCON_LUADLL_API " + head + ";\n";
 			output += head + body;
 
@@ -1004,14 +3104,14 @@ int main(int argc, char *argv[]) {
 
 		arg_information id_in = {
 			.meta_type = meta_information::id,
-			.type = normalize_type(convert_to_id(ob.name), made_types),
+			.type = normalize_type(convert_to_id(ctx, ob.name), ctx.made_types),
 			.name = "id",
 		};
 
 		auto gen_value = [&](std::string name, std::string base) {
 			arg_information out = {
 				.meta_type = meta_information::value,
-				.type = normalize_type(base, made_types),
+				.type = normalize_type(base, ctx.made_types),
 				.name = name
 			};
 			return out;
@@ -1028,14 +3128,48 @@ int main(int argc, char *argv[]) {
 		auto bool_type = gen_value("value", "bool");
 
 		// append_id_to_value("is_valid", "bool", "boolean");
+		auto const object_indexes = indexed_properties(ctx, ob);
+		for(auto p : object_indexes) {
+			output += make_property_index(ctx, parsed_file, project_prefix, ob, *p, header_output, lua_cdef, lua_cdef_wrapper, lua_namespace);
+		}
+		auto const live = has_live_list(ob) ? project_prefix + ob.name + "_live" : std::string("");
+		auto const object_position = std::to_string(&ob - parsed_file.relationship_objects.data());
+		auto const events = has_events(ob);
+		auto push_event = [&](std::string const& indent, char const* kind, std::string const& id, std::string const& link, std::string const& value, std::string const& slot = "0") {
+			return indent + project_prefix + "push_event(" + kind + ", " + object_position + ", " + id + ", " + link + ", " + slot + ", " + value + ");\n";
+		};
+		if(live.length() > 0) {
+			output += make_live_list(ctx, parsed_file, project_prefix, ob, header_output, lua_cdef, lua_cdef_wrapper, lua_namespace);
+		}
+
 		append(gen_call_information("is_valid", array_access::function_call, {id_in}, bool_type));
+		{
+			auto const fname = project_prefix + ob.name + "_is_valid_bulk";
+			header_output += "DCON_LUADLL_API void " + fname + "(int32_t const* ids, int32_t count, uint8_t* mask_out); \n";
+			output += "void " + fname + "(int32_t const* ids, int32_t count, uint8_t* mask_out) { \n";
+			output += "\tfor(int32_t i = 0; i < count; ++i)\n";
+			output += "\t\tmask_out[i] = ids[i] >= 0 && " + ctx.game_state + ob.name + "_is_valid(" + convert_raw_to_id(parsed_file, ob.name, "ids[i]") + ") ? 1 : 0;\n";
+			output += "}\n";
+
+			lua_cdef += "void " + fname + "(int32_t const* ids, int32_t count, uint8_t* mask_out);\n";
+			lua_cdef_wrapper += "---@param ids ffi.cdata*\n";
+			lua_cdef_wrapper += "---@param count number\n";
+			lua_cdef_wrapper += "---@param mask_out ffi.cdata*\n";
+			lua_cdef_wrapper += "function " + lua_namespace + ".is_valid_bulk(ids, count, mask_out)\n";
+			lua_cdef_wrapper += "\tffi.C." + fname + "(ids, count, mask_out)\n";
+			lua_cdef_wrapper += "end\n";
+		}
 		append(gen_call_information("size", array_access::function_call, {}, size_type));
-		append(gen_call_information("resize", array_access::function_call, {size_type}, void_type));
+		{
+			auto resize = gen_call_information("resize", array_access::function_call, {size_type}, void_type);
+			resize.after_call = rebuild_object_indexes(ctx, "\t", project_prefix, ob);
+			append(resize);
+		}
 
 		for(auto& prop : ob.properties) {
 			auto is_bool = prop.type == property_type::array_bitfield || prop.type == property_type::bitfield;
-			arg_information value = normalize_argument("value", is_bool, prop.data_type);
-			auto index = normalize_argument("index", false, prop.array_index_type);
+			arg_information value = normalize_argument(ctx, "value", is_bool, prop.data_type);
+			auto index = normalize_argument(ctx, "index", false, prop.array_index_type);
 
 			if(prop.type == property_type::array_bitfield || prop.type == property_type::array_vectorizable || prop.type == property_type::array_other) {
 				if((prop.hook_get || !prop.is_derived) && value.type.normalized != lua_type_match::lua_object && (index.meta_type != meta_information::value_pointer)) {
@@ -1126,8 +3260,8 @@ int main(int argc, char *argv[]) {
 							value
 						)
 					);
-					if (value.type.normalized != lua_type_match::opaque) append(
-						gen_call_information(
+					if (value.type.normalized != lua_type_match::opaque) {
+						auto set = gen_call_information(
 							"set_" + prop.name,
 							array_access::function_call,
 							{
@@ -1135,8 +3269,13 @@ int main(int argc, char *argv[]) {
 								value
 							},
 							void_type
-						)
-					);
+						);
+						if(std::find(object_indexes.begin(), object_indexes.end(), &prop) != object_indexes.end()) {
+							set.before_call = "\t" + index_name(project_prefix, ob, prop) + "_remove(" + api_arg_string(id_in, 0) + ");\n";
+							set.after_call = "\t" + index_name(project_prefix, ob, prop) + "_insert(" + api_arg_string(id_in, 0) + ");\n";
+						}
+						append(set);
+					}
 				}
 			}
 		} // end: loop over properties
@@ -1144,9 +3283,30 @@ int main(int argc, char *argv[]) {
 		for(auto& indexed : ob.indexed_objects) {
 			arg_information value {
 				.meta_type = meta_information::id,
-				.type = normalize_type(convert_to_id(indexed.type_name), made_types),
+				.type = normalize_type(convert_to_id(ctx, indexed.type_name), ctx.made_types),
 				.name = "linked_id",
 			};
+			// setters of links report the new target of the slot they set, try_set_ only when it changed the slot
+			auto link_setter = [&](std::string const& name, bool conditional) {
+				auto const multiple = indexed.multiplicity > 1;
+				auto const value_position = multiple ? 2 : 1;
+				auto call = multiple
+					? gen_call_information(name + indexed.property_name, array_access::function_call, {id_in, int_type, value}, void_type)
+					: gen_call_information(name + indexed.property_name, array_access::function_call, {id_in, value}, void_type);
+				if(events) {
+					auto const link_position = std::to_string(&indexed - ob.indexed_objects.data());
+					auto const slot = multiple ? api_arg_string(int_type, 1) : std::string("0");
+					auto const event = push_event(conditional ? "\t\t" : "\t", "3", api_arg_string(id_in, 0), link_position, api_arg_string(value, value_position), slot);
+					if(conditional) {
+						auto const current_link = ctx.game_state + ob.name + "_get_" + indexed.property_name + "(" + container_arg_string(id_in, 0) + (multiple ? ", " + container_arg_string(int_type, 1) : std::string("")) + ")";
+						call.before_call = "\tauto const previous_link = " + current_link + ";\n";
+						call.after_call = "\tif(previous_link != " + container_arg_string(value, value_position) + " && " + current_link + " == " + container_arg_string(value, value_position) + ")\n" + event;
+					} else {
+						call.after_call = event;
+					}
+				}
+				return call;
+			};
 			if(indexed.index == index_type::at_most_one && ob.primary_key == indexed) {
 				append(gen_call_information(
 					"get_" + indexed.property_name,
@@ -1154,18 +3314,8 @@ int main(int argc, char *argv[]) {
 					{id_in},
 					value
 				));
-				append(gen_call_information(
-					"set_" + indexed.property_name,
-					array_access::function_call,
-					{id_in, value},
-					void_type
-				));
-				append(gen_call_information(
-					"try_set_" + indexed.property_name,
-					array_access::function_call,
-					{id_in, value},
-					void_type
-				));
+				append(link_setter("set_", false));
+				append(link_setter("try_set_", true));
 			} else { // if(indexed.index == index_type::at_most_one ||  index_type::many || unindexed
 				if(indexed.multiplicity == 1) {
 					append(gen_call_information(
@@ -1174,18 +3324,8 @@ int main(int argc, char *argv[]) {
 						{id_in},
 						value
 					));
-					append(gen_call_information(
-						"set_" + indexed.property_name,
-						array_access::function_call,
-						{id_in, value},
-						void_type
-					));
-					append(gen_call_information(
-						"try_set_" + indexed.property_name,
-						array_access::function_call,
-						{id_in, value},
-						void_type
-					));
+					append(link_setter("set_", false));
+					append(link_setter("try_set_", true));
 				} else {
 					append(gen_call_information(
 						"get_" + indexed.property_name,
@@ -1193,18 +3333,8 @@ int main(int argc, char *argv[]) {
 						{id_in, int_type},
 						value
 					));
-					append(gen_call_information(
-						"set_" + indexed.property_name,
-						array_access::function_call,
-						{id_in, int_type, value},
-						void_type
-					));
-					append(gen_call_information(
-						"try_set_" + indexed.property_name,
-						array_access::function_call,
-						{id_in, int_type, value},
-						void_type
-					));
+					append(link_setter("set_", false));
+					append(link_setter("try_set_", true));
 				}
 			}
 		} // end: loop over indexed objects
@@ -1212,7 +3342,7 @@ int main(int argc, char *argv[]) {
 		for(auto& involved_in : ob.relationships_involved_in) {
 			arg_information involved_relation {
 				.meta_type = meta_information::id,
-				.type = normalize_type(convert_to_id(involved_in.relation_name), made_types),
+				.type = normalize_type(convert_to_id(ctx, involved_in.relation_name), ctx.made_types),
 				.name = "relation",
 			};
 			if(involved_in.linked_as->index == index_type::at_most_one) {
@@ -1242,7 +3372,7 @@ int main(int argc, char *argv[]) {
 					header_output += "DCON_LUADLL_API int32_t " + access + "(int32_t i); \n";
 					output += "int32_t " + access + "(int32_t i) { \n";
 					output += "\tauto index = " + parsed_file.namspace + "::" + ob.name + "_id{" + parsed_file.namspace + "::" + ob.name + "_id::value_base_t(i)};\n";
-					output += "\tauto rng = " + game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
+					output += "\tauto rng = " + ctx.game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
 					output += "\treturn int32_t(rng.end() - rng.begin());\n";
 					output += "}\n";
 					lua_cdef += "int32_t " + access + "(int32_t i);\n";
@@ -1256,7 +3386,7 @@ int main(int argc, char *argv[]) {
 					header_output += "DCON_LUADLL_API int32_t " + access + "(int32_t i, int32_t subindex); \n";
 					output += "int32_t " + access + "(int32_t i, int32_t subindex) { \n";
 					output += "\tauto index = " + parsed_file.namspace + "::" + ob.name + "_id{" + parsed_file.namspace + "::" + ob.name + "_id::value_base_t(i)};\n";
-					output += "\tauto rng = " + game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
+					output += "\tauto rng = " + ctx.game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
 					output += "\treturn rng.begin()[subindex].id.index();\n";
 					output += "}\n";
 					lua_cdef += "int32_t " + access + "(int32_t i, int32_t subindex);\n";
@@ -1278,14 +3408,14 @@ int main(int argc, char *argv[]) {
 					header_output += "DCON_LUADLL_API int32_t " + project_prefix + ob.name + "_get_range_" + involved_in.relation_name + "(int32_t i); \n";
 					output += "int32_t " + project_prefix + ob.name + "_get_range_" + involved_in.relation_name  + "(int32_t i) { \n";
 					output += "\tauto index = " + parsed_file.namspace + "::" + ob.name + "_id{" + parsed_file.namspace + "::" + ob.name + "_id::value_base_t(i)};\n";
-					output += "\tauto rng = "+game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
+					output += "\tauto rng = "+ctx.game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
 					output += "\treturn int32_t(rng.end() - rng.begin());\n";
 					output += "}\n";
 
 					header_output += "DCON_LUADLL_API int32_t " + project_prefix + ob.name + "_get_index_" + involved_in.relation_name + "(int32_t i, int32_t subindex); \n";
 					output += "int32_t " + project_prefix + ob.name + "_get_index_" + involved_in.relation_name + "(int32_t i, int32_t subindex) { \n";
 					output += "\tauto index = " + parsed_file.namspace + "::" + ob.name + "_id{" + parsed_file.namspace + "::" + ob.name + "_id::value_base_t(i)};\n";
-					output += "\tauto rng = "+game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
+					output += "\tauto rng = "+ctx.game_state + ob.name + "_get_" + involved_in.relation_name + "_as_" + involved_in.linked_as->property_name + "(index);\n";
 					output += "\treturn rng.begin()[subindex].id.index();\n";
 					output += "}\n";
 				}
@@ -1298,33 +3428,47 @@ int main(int argc, char *argv[]) {
 		auto make_pop_back_delete = [&]() {
 			header_output += "DCON_LUADLL_API void " + project_prefix + "pop_back_" + ob.name + "(); \n";
 			output += "void " + project_prefix + "pop_back_" + ob.name + "() { \n";
-			output += "\tif("+game_state + ob.name + "_size() > 0) {\n";
-			output += "\t\tauto index = " + parsed_file.namspace + "::" + ob.name + "_id{" + parsed_file.namspace + "::" + ob.name + "_id::value_base_t("+game_state + ob.name + "_size() - 1)};\n";
+			output += "\tif("+ctx.game_state + ob.name + "_size() > 0) {\n";
+			output += "\t\tauto index = " + parsed_file.namspace + "::" + ob.name + "_id{" + parsed_file.namspace + "::" + ob.name + "_id::value_base_t("+ctx.game_state + ob.name + "_size() - 1)};\n";
 			for(auto& p : ob.properties) {
 				if(p.data_type == "lua_reference_type") {
 					if(p.type == property_type::array_vectorizable || p.type == property_type::array_other) {
-						output += "\t\tfor(auto i = "+game_state + ob.name + "_get_" + p.name + "_size(); i-->0; ) {\n";
-						if(made_types.count(p.array_index_type) > 0) {
-							output += "\t\t\tif(auto result = "+game_state + ob.name + "_get_" + p.name + "(index, " + parsed_file.namspace + "::" + p.array_index_type + "{" + parsed_file.namspace + "::" + p.array_index_type + "::value_base_t(i)}); result != 0) release_object_function(result);\n";
+						output += "\t\tfor(auto i = "+ctx.game_state + ob.name + "_get_" + p.name + "_size(); i-->0; ) {\n";
+						if(ctx.made_types.count(p.array_index_type) > 0) {
+							output += "\t\t\tif(auto result = "+ctx.game_state + ob.name + "_get_" + p.name + "(index, " + parsed_file.namspace + "::" + p.array_index_type + "{" + parsed_file.namspace + "::" + p.array_index_type + "::value_base_t(i)}); result != 0) release_object_function(result);\n";
 						} else {
-							output += "\t\t\tif(auto result = "+game_state + ob.name + "_get_" + p.name + "(index, " + p.array_index_type + "(i)); result != 0) release_object_function(result);\n";
+							output += "\t\t\tif(auto result = "+ctx.game_state + ob.name + "_get_" + p.name + "(index, " + p.array_index_type + "(i)); result != 0) release_object_function(result);\n";
 						}
 						output += "\t\t}\n";
 					} else if(p.type == property_type::special_vector) {
 						output += "\t\t" + project_prefix + ob.name + "_resize_" + p.name + "(index.index(), 0);\n";
 					} else {
-						output += "\t\tif(auto result = "+game_state + ob.name + "_get_" + p.name + "(index); result != 0) release_object_function(result);\n";
+						output += "\t\tif(auto result = "+ctx.game_state + ob.name + "_get_" + p.name + "(index); result != 0) release_object_function(result);\n";
 					}
 				}
 			}
-			output += "\t\t"+game_state+"pop_back_" + ob.name + "();\n";
+			for(auto p : object_indexes)
+				output += "\t\t" + index_name(project_prefix, ob, *p) + "_remove(int32_t(index.index()));\n";
+			if(live.length() > 0)
+				output += "\t\t" + live + "_remove(int32_t(index.index()));\n";
+			if(events)
+				output += push_event("\t\t", "1", "int32_t(index.index())", "-1", "-1");
+			output += "\t\t"+ctx.game_state+"pop_back_" + ob.name + "();\n";
 			output += "\t}\n";
 			output += "}\n";
 		};
 		auto make_simple_create = [&]() {
 			header_output += "DCON_LUADLL_API int32_t " + project_prefix + "create_" + ob.name + "(); \n";
 			output += "int32_t " + project_prefix + "create_" + ob.name + "() { \n";
-			output += "\tauto result = "+game_state+"create_" + ob.name + "();\n";
+			output += "\tauto result = "+ctx.game_state+"create_" + ob.name + "();\n";
+			for(auto p : object_indexes) {
+				auto const index = index_name(project_prefix, ob, *p);
+				output += "\t" + index + "_insert(int32_t(result.index()));\n";
+			}
+			if(live.length() > 0)
+				output += "\t" + live + "_insert(int32_t(result.index()));\n";
+			if(events)
+				output += push_event("\t", "0", "int32_t(result.index())", "-1", "-1");
 			output += "\treturn result.index();\n";
 			output += "}\n";
 		};
@@ -1335,21 +3479,47 @@ int main(int argc, char *argv[]) {
 			for(auto& p : ob.properties) {
 				if(p.data_type == "lua_reference_type") {
 					if(p.type == property_type::array_vectorizable || p.type == property_type::array_other) {
-						output += "\t\tfor(auto i = "+game_state + ob.name + "_get_" + p.name + "_size(); i-->0; ) {\n";
-						if(made_types.count(p.array_index_type) > 0) {
-							output += "\t\t\tif(auto result = "+game_state + ob.name + "_get_" + p.name + "(index, " + parsed_file.namspace + "::" + p.array_index_type + "{" + parsed_file.namspace + "::" + p.array_index_type + "::value_base_t(i)}); result != 0) release_object_function(result);\n";
+						output += "\t\tfor(auto i = "+ctx.game_state + ob.name + "_get_" + p.name + "_size(); i-->0; ) {\n";
+						if(ctx.made_types.count(p.array_index_type) > 0) {
+							output += "\t\t\tif(auto result = "+ctx.game_state + ob.name + "_get_" + p.name + "(index, " + parsed_file.namspace + "::" + p.array_index_type + "{" + parsed_file.namspace + "::" + p.array_index_type + "::value_base_t(i)}); result != 0) release_object_function(result);\n";
 						} else {
-							output += "\t\t\tif(auto result = "+game_state + ob.name + "_get_" + p.name + "(index, " + p.array_index_type + "(i)); result != 0) release_object_function(result);\n";
+							output += "\t\t\tif(auto result = "+ctx.game_state + ob.name + "_get_" + p.name + "(index, " + p.array_index_type + "(i)); result != 0) release_object_function(result);\n";
 						}
 						output += "\t\t}\n";
 					} else if(p.type == property_type::special_vector) {
 						output += "\t\t" + project_prefix + ob.name + "_resize_" + p.name + "(j, 0);\n";
 					} else {
-						output += "\t\tif(auto result = "+game_state + ob.name + "_get_" + p.name + "(index); result != 0) release_object_function(result);\n";
+						output += "\t\tif(auto result = "+ctx.game_state + ob.name + "_get_" + p.name + "(index); result != 0) release_object_function(result);\n";
 					}
 				}
 			}
-			output += "\t"+game_state+"delete_" + ob.name + "(index);\n";
+			if(events)
+				output += push_event("\t", "1", "j", "-1", "-1");
+			if((object_indexes.size() > 0 || live.length() > 0 || events) && ob.store_type == storage_type::compactable) {
+				// the last object is moved into the freed slot
+				output += "\tauto const last = int32_t(" + ctx.game_state + ob.name + "_size()) - 1;\n";
+				for(auto p : object_indexes) {
+					output += "\t" + index_name(project_prefix, ob, *p) + "_remove(j);\n";
+					output += "\t" + index_name(project_prefix, ob, *p) + "_remove(last);\n";
+				}
+				if(live.length() > 0)
+					output += "\t" + live + "_remove(last);\n";
+				output += "\t"+ctx.game_state+"delete_" + ob.name + "(index);\n";
+				if(object_indexes.size() > 0 || events) {
+					output += "\tif(j < last) {\n";
+					for(auto p : object_indexes)
+						output += "\t\t" + index_name(project_prefix, ob, *p) + "_insert(j);\n";
+					if(events)
+						output += push_event("\t\t", "2", "j", "-1", "last");
+					output += "\t}\n";
+				}
+			} else {
+				for(auto p : object_indexes)
+					output += "\t" + index_name(project_prefix, ob, *p) + "_remove(j);\n";
+				if(live.length() > 0)
+					output += "\t" + live + "_remove(j);\n";
+				output += "\t"+ctx.game_state+"delete_" + ob.name + "(index);\n";
+			}
 			output += "}\n";
 		};
 		auto make_relation_create = [&]() {
@@ -1380,13 +3550,21 @@ int main(int argc, char *argv[]) {
 
 			header_output += "DCON_LUADLL_API int32_t " + project_prefix + "try_create_" + ob.name + "(" + pargs + "); \n";
 			output += "int32_t " + project_prefix + "try_create_" + ob.name + "(" + pargs + ") { \n";
-			output += "\tauto result = "+game_state+"try_create_" + ob.name + "(" + params + ");\n";
+			output += "\tauto result = "+ctx.game_state+"try_create_" + ob.name + "(" + params + ");\n";
+			if(events) {
+				output += "\tif(result)\n";
+				output += push_event("\t\t", "0", "int32_t(result.index())", "-1", "-1");
+			}
 			output += "\treturn result.index();\n";
 			output += "}\n";
 
 			header_output += "DCON_LUADLL_API int32_t " + project_prefix + "force_create_" + ob.name + "(" + pargs + "); \n";
 			output += "int32_t " + project_prefix + "force_create_" + ob.name + "(" + pargs + ") { \n";
-			output += "\tauto result = "+game_state+"force_create_" + ob.name + "(" + params + ");\n";
+			output += "\tauto result = "+ctx.game_state+"force_create_" + ob.name + "(" + params + ");\n";
+			if(events) {
+				output += "\tif(result)\n";
+				output += push_event("\t\t", "0", "int32_t(result.index())", "-1", "-1");
+			}
 			output += "\treturn result.index();\n";
 			output += "}\n";
 		};
@@ -1449,52 +3627,321 @@ int main(int argc, char *argv[]) {
 
 			header_output += "DCON_LUADLL_API int32_t " + project_prefix + "get_" + ob.name + "_by_" + cc.name + "(" + pargs +"); \n";
 			output += "int32_t " + project_prefix + "get_" + ob.name + "_by_" + cc.name + "(" + pargs + ") { \n";
-			output += "\tauto result = "+game_state+"get_" + ob.name + "_by_" + cc.name + "(" + params + ");\n";
+			output += "\tauto result = "+ctx.game_state+"get_" + ob.name + "_by_" + cc.name + "(" + params + ");\n";
 			output += "\treturn result.index();\n";
 			output += "}\n";
 
 		}
 
-		lua_cdef += "]]\n";
+		for(auto& fn : ob.member_functions) {
+			std::string return_type;
+			std::vector<std::string> parameter_types;
+			if(!parse_member_signature(parsed_file, fn, return_type, parameter_types))
+				continue;
+
+			bool supported = true;
+			std::vector<arg_information> in{ id_in };
+			for(size_t i = 0; i < parameter_types.size(); ++i) {
+				auto arg = normalize_argument(ctx, fn.parameter_names[i], false, parameter_types[i]);
+				if(arg.meta_type == meta_information::value_pointer)
+					supported = false;
+				in.push_back(arg);
+			}
+			arg_information out = void_type;
+			if(return_type != "void") {
+				out = normalize_argument(ctx, "value", false, return_type);
+				if(out.meta_type == meta_information::value_pointer)
+					supported = false;
+			}
+			if(!supported)
+				continue;
+
+			// member functions may write any column, so every index is rebuilt before its next lookup
+			auto const invalidate = has_native_indexes(ctx, parsed_file) ? "\t" + project_prefix + "invalidate_indexes();\n" : std::string("");
+			auto member = gen_call_information(fn.name, array_access::member_call, in, out);
+			member.before_call = invalidate;
+			append(member);
+
+			// the same call over an array of ids, with the remaining arguments shared by all of them;
+			// the arguments are prefixed so that they cannot collide with ids, count, out or the loop index
+			auto const bulk = project_prefix + ob.name + "_" + fn.name + "_bulk";
+			std::string params = "int32_t const* ids, int32_t count";
+			std::string lua_params = "ids, count";
+			std::string conversions;
+			std::string args;
+			for(size_t i = 1; i < in.size(); ++i) {
+				auto const arg_name = "arg_" + in[i].name;
+				params += ", " + in[i].type.api_type + " " + arg_name;
+				lua_params += ", " + arg_name;
+				if(args.length() > 0)
+					args += ", ";
+				if(in[i].meta_type == meta_information::id) {
+					conversions += "\tauto " + arg_name + "_id = " + convert_raw_to_id_from_id(parsed_file, in[i].type.c_type, arg_name) + ";\n";
+					args += arg_name + "_id";
+				} else {
+					args += arg_name;
+				}
+			}
+			if(out.meta_type != meta_information::empty) {
+				params += ", " + to_string(out) + "* out";
+				lua_params += ", out";
+			}
+
+			header_output += "DCON_LUADLL_API void " + bulk + "(" + params + "); \n";
+			output += "void " + bulk + "(" + params + ") { \n";
+			output += invalidate;
+			output += conversions;
+			output += "\tfor(int32_t bulk_row = 0; bulk_row < count; ++bulk_row) {\n";
+			std::string call = parsed_file.namspace + "::fatten(" + container_reference(ctx) + ", " + convert_raw_to_id(parsed_file, ob.name, "ids[bulk_row]") + ")." + fn.name + "(" + args + ")";
+			if(out.meta_type == meta_information::empty) {
+				output += "\t\t" + call + ";\n";
+			} else if(out.meta_type == meta_information::id) {
+				output += "\t\tout[bulk_row] = " + call + ".index();\n";
+			} else {
+				output += "\t\tout[bulk_row] = " + call + ";\n";
+			}
+			output += "\t}\n";
+			output += "}\n";
+
+			lua_cdef += "void " + bulk + "(" + params + ");\n";
+			lua_cdef_wrapper += "---@param ids ffi.cdata*\n";
+			lua_cdef_wrapper += "---@param count number\n";
+			for(size_t i = 1; i < in.size(); ++i) {
+				lua_cdef_wrapper += "---@param arg_" + in[i].name + " " + (in[i].meta_type == meta_information::id ? lua_id(in[i].type.c_type) : in[i].type.lua_type) + "\n";
+			}
+			if(out.meta_type != meta_information::empty) {
+				lua_cdef_wrapper += "---@param out ffi.cdata*\n";
+			}
+			lua_cdef_wrapper += "function " + lua_namespace + "." + fn.name + "_bulk(" + lua_params + ")\n";
+			lua_cdef_wrapper += "\tffi.C." + bulk + "(" + lua_params + ")\n";
+			lua_cdef_wrapper += "end\n";
+		}
 
 		{
-			std::fstream lua_file;
-			std::filesystem::create_directory(lua_folder);
-			lua_file.open(lua_folder + "/" + ob.name + ".lua", std::ios::out);
-			if(lua_file.is_open()) {
-				lua_file << lua_cdef << lua_cdef_wrapper;
-				lua_file.close();
+			// the kernel receives half open ranges of ids, which for erasable objects may include deleted ones
+			auto const fname = project_prefix + "parallel_for_" + ob.name;
+			auto const params = std::string("void (*kernel)(int32_t first, int32_t last, void* user_data), void* user_data, int32_t chunk_size");
+			header_output += "DCON_LUADLL_API void " + fname + "(" + params + "); \n";
+			output += "void " + fname + "(" + params + ") { \n";
+			output += "\tint32_t const size = int32_t(" + ctx.game_state + ob.name + "_size());\n";
+			output += "\tif(chunk_size <= 0)\n";
+			output += "\t\tchunk_size = 1024;\n";
+			// rounded up without forming size + chunk_size, which overflows for chunk sizes near the int32_t limit
+			output += "\tint32_t const chunks = size / chunk_size + (size % chunk_size != 0 ? 1 : 0);\n";
+			output += "\t" + project_prefix + "run_tasks(chunks, [&](int32_t chunk) {\n";
+			output += "\t\tint32_t const first = chunk * chunk_size;\n";
+			output += "\t\tkernel(first, size - first < chunk_size ? size : first + chunk_size, user_data);\n";
+			output += "\t});\n";
+			output += "}\n";
+
+			lua_cdef += "void " + fname + "(" + params + ");\n";
+			lua_cdef_wrapper += "---runs a native kernel over all ids on the worker threads; the kernel must not call back into Lua\n";
+			lua_cdef_wrapper += "---@param kernel ffi.cdata*\n";
+			lua_cdef_wrapper += "---@param user_data ffi.cdata*|nil\n";
+			lua_cdef_wrapper += "---@param chunk_size number\n";
+			lua_cdef_wrapper += "function " + lua_namespace + ".parallel_for(kernel, user_data, chunk_size)\n";
+			lua_cdef_wrapper += "\tffi.C." + fname + "(kernel, user_data, chunk_size)\n";
+			lua_cdef_wrapper += "end\n";
+		}
+
+		for(size_t i = 0; i < parsed_file.kernels.size(); ++i) {
+			auto& k = parsed_file.kernels[i];
+			if(k.object != ob.name)
+				continue;
+			std::string params;
+			std::string lua_params;
+			for(size_t j = 0; j < k.parameter_names.size(); ++j) {
+				if(j > 0) {
+					params += ", ";
+					lua_params += ", ";
+				}
+				params += k.parameter_types[j] + " " + k.parameter_names[j];
+				lua_params += k.parameter_names[j];
+			}
+			auto const fname = project_prefix + "kernel_" + k.name;
+			header_output += "DCON_LUADLL_API void " + fname + "(" + params + "); \n";
+			output += "void " + fname + "(" + params + ") { \n";
+			for(auto p : object_indexes) {
+				if(kernel_bodies[i].find(ctx.game_state + ob.name + "_set_" + p->name + "(") != std::string::npos)
+					output += "\t" + index_name(project_prefix, ob, *p) + "_dirty = true;\n";
+			}
+			output += "\t" + ctx.game_state + "execute_serial_over_" + ob.name + "([&](auto ids) {\n";
+			output += kernel_bodies[i];
+			output += "\t});\n";
+			output += "}\n";
+
+			lua_cdef += "void " + fname + "(" + params + ");\n";
+			for(auto& pname : k.parameter_names)
+				lua_cdef_wrapper += "---@param " + pname + " number\n";
+			lua_cdef_wrapper += "function " + lua_namespace + ".kernel_" + k.name + "(" + lua_params + ")\n";
+			lua_cdef_wrapper += "\tffi.C." + fname + "(" + lua_params + ")\n";
+			lua_cdef_wrapper += "end\n";
+		}
+
+		output += make_cursors(ctx, parsed_file, project_prefix, ob, header_output, lua_cdef, lua_cdef_wrapper, lua_namespace);
+		output += make_histograms(ctx, parsed_file, project_prefix, ob, header_output, lua_cdef, lua_cdef_wrapper, lua_namespace);
+		output += make_gathers(ctx, parsed_file, project_prefix, ob, header_output, lua_cdef, lua_cdef_wrapper, lua_namespace);
+
+		for(auto& sw : ob.swappable_list) {
+			auto a = std::find_if(ob.properties.begin(), ob.properties.end(), [&](property_def const& p) { return p.name == sw.property_a; });
+			auto b = std::find_if(ob.properties.begin(), ob.properties.end(), [&](property_def const& p) { return p.name == sw.property_b; });
+			if(a == ob.properties.end() || b == ob.properties.end())
+				continue;
+			if(a->is_derived || b->is_derived || a->type != b->type || a->data_type != b->data_type || a->array_index_type != b->array_index_type)
+				continue;
+			if(a->type == property_type::special_vector)
+				continue;
+
+			// exchanges the contents of both columns for every slot, live or not, in a single call
+			auto const fname = project_prefix + ob.name + "_swap_" + a->name + "_" + b->name;
+			header_output += "DCON_LUADLL_API void " + fname + "(); \n";
+			output += "void " + fname + "() { \n";
+			output += "\tuint32_t const count = " + ctx.game_state + ob.name + "_size();\n";
+			if(a->type == property_type::vectorizable || a->type == property_type::bitfield) {
+				// plain columns are swapped as raw storage, bitfields packed eight rows to a byte
+				auto const column = container_reference(ctx) + "." + ob.name + ".m_";
+				auto const length = a->type == property_type::bitfield ? std::string("(count + 7) / 8") : std::string("count");
+				output += "\tstd::swap_ranges(" + column + a->name + ".vptr(), " + column + a->name + ".vptr() + " + length + ", " + column + b->name + ".vptr());\n";
 			} else {
-				std::abort();
+				output += "\tfor(uint32_t i = 0; i < count; ++i) {\n";
+				output += "\t\tauto index = " + convert_raw_to_id(parsed_file, ob.name, "i") + ";\n";
+				if(a->type == property_type::array_vectorizable || a->type == property_type::array_bitfield || a->type == property_type::array_other) {
+					std::string array_index;
+					if(ctx.made_types.count(a->array_index_type) > 0) {
+						array_index = parsed_file.namspace + "::" + a->array_index_type + "{" + parsed_file.namspace + "::" + a->array_index_type + "::value_base_t(j)}";
+					} else {
+						array_index = a->array_index_type + "(j)";
+					}
+					output += "\t\tfor(auto j = " + ctx.game_state + ob.name + "_get_" + a->name + "_size(); j-->0; ) {\n";
+					output += "\t\t\tauto temp = " + ctx.game_state + ob.name + "_get_" + a->name + "(index, " + array_index + ");\n";
+					output += "\t\t\t" + ctx.game_state + ob.name + "_set_" + a->name + "(index, " + array_index + ", " + ctx.game_state + ob.name + "_get_" + b->name + "(index, " + array_index + "));\n";
+					output += "\t\t\t" + ctx.game_state + ob.name + "_set_" + b->name + "(index, " + array_index + ", temp);\n";
+					output += "\t\t}\n";
+				} else {
+					output += "\t\tauto temp = " + ctx.game_state + ob.name + "_get_" + a->name + "(index);\n";
+					output += "\t\t" + ctx.game_state + ob.name + "_set_" + a->name + "(index, " + ctx.game_state + ob.name + "_get_" + b->name + "(index));\n";
+					output += "\t\t" + ctx.game_state + ob.name + "_set_" + b->name + "(index, temp);\n";
+				}
+				output += "\t}\n";
+			}
+			for(auto p : object_indexes) {
+				if(p == &*a || p == &*b)
+					output += "\t" + project_prefix + ob.name + "_rebuild_" + p->name + "_index();\n";
 			}
+			output += "}\n";
+
+			lua_cdef += "void " + fname + "();\n";
+			lua_cdef_wrapper += "function " + lua_namespace + ".swap_" + a->name + "_" + b->name + "()\n";
+			lua_cdef_wrapper += "\tffi.C." + fname + "()\n";
+			lua_cdef_wrapper += "end\n";
 		}
+
+		lua_cdef += "]]\n";
+
+		buffers.lua = lua_cdef + lua_cdef_wrapper;
+	};
+
+	{
+		std::atomic<size_t> next_object = 0;
+		auto worker = [&]() {
+			for(size_t i = next_object++; i < object_outputs.size(); i = next_object++)
+				generate_object(parsed_file.relationship_objects[i], object_outputs[i]);
+		};
+		size_t const worker_count = std::min(size_t(std::max(1u, std::thread::hardware_concurrency())), object_outputs.size());
+		std::vector<std::thread> workers;
+		for(size_t i = 1; i < worker_count; ++i)
+			workers.emplace_back(worker);
+		worker();
+		for(auto& w : workers)
+			w.join();
+	}
+
+	for(auto& ob_out : object_outputs) {
+		if(split_objects)
+			object_sources.push_back(object_source_prelude + ob_out.source + "\n");
+		else
+			output += ob_out.source;
+		header_output += ob_out.header;
+		lua_ids_collection += ob_out.lua_ids;
 	}
 
 	output += "\n";
 	//reset function
 
+	auto const rebuild_guard = has_native_indexes(ctx, parsed_file) ? "\t" + project_prefix + "index_guard const rebuild_guard;\n" : std::string("");
+	if(has_native_indexes(ctx, parsed_file)) {
+		header_output += "DCON_LUADLL_API void " + project_prefix + "rebuild_indexes(); \n";
+		output += "void " + project_prefix + "rebuild_indexes() { \n";
+		for(auto& ob : parsed_file.relationship_objects)
+			output += rebuild_object_indexes(ctx, "\t", project_prefix, ob);
+		output += "}\n";
+		// the flags may live in the translation units of split objects
+		for(auto& ob : parsed_file.relationship_objects) {
+			for(auto p : indexed_properties(ctx, ob))
+				output += "extern bool " + index_name(project_prefix, ob, *p) + "_dirty;\n";
+			if(has_live_list(ob))
+				output += "extern bool " + project_prefix + ob.name + "_live_dirty;\n";
+		}
+		output += "void " + project_prefix + "invalidate_indexes() { \n";
+		for(auto& ob : parsed_file.relationship_objects) {
+			for(auto p : indexed_properties(ctx, ob))
+				output += "\t" + index_name(project_prefix, ob, *p) + "_dirty = true;\n";
+			if(has_live_list(ob))
+				output += "\t" + project_prefix + ob.name + "_live_dirty = true;\n";
+		}
+		output += "}\n";
+		// marks the indexes for rebuilding when a load leaves its scope, whichever way it exits
+		output += "struct " + project_prefix + "index_guard {\n";
+		output += "\t~" + project_prefix + "index_guard() { " + project_prefix + "invalidate_indexes(); }\n";
+		output += "};\n";
+	}
+
 	header_output += "DCON_LUADLL_API int32_t " + project_prefix + "reset(); \n";
 	output += "int32_t " + project_prefix + "reset() { \n";
-	output += "\t"+game_state+"reset();\n";
+	output += rebuild_guard;
+	output += "\t"+ctx.game_state+"reset();\n";
 	output += "\treturn 0;\n";
 	output += "}\n";
 
 
+	if(parsed_file.load_save_routines.size() > 0 && parsed_file.relationship_objects.size() > 0) {
+		output += "\n";
+		output += make_section_helpers(ctx, parsed_file, project_prefix);
+
+		header_output += "DCON_LUADLL_API int32_t " + project_prefix + "section_index(char const* object_name); \n";
+		output += "int32_t " + project_prefix + "section_index(char const* object_name) { \n";
+		output += "\tfor(int32_t i = 0; i < " + project_prefix + "section_count; ++i) {\n";
+		output += "\t\tif(std::strcmp(object_name, " + project_prefix + "section_names[i]) == 0)\n";
+		output += "\t\t\treturn i;\n";
+		output += "\t}\n";
+		output += "\treturn -1;\n";
+		output += "}\n";
+
+		header_output += "DCON_LUADLL_API void " + project_prefix + "get_section_statistics(uint64_t* raw_bytes, uint64_t* stored_bytes, double* save_seconds, double* load_seconds); \n";
+		output += "void " + project_prefix + "get_section_statistics(uint64_t* raw_bytes, uint64_t* stored_bytes, double* save_seconds, double* load_seconds) { \n";
+		output += "\t*raw_bytes = " + project_prefix + "last_section_statistics.raw_bytes;\n";
+		output += "\t*stored_bytes = " + project_prefix + "last_section_statistics.stored_bytes;\n";
+		output += "\t*save_seconds = " + project_prefix + "last_section_statistics.save_seconds;\n";
+		output += "\t*load_seconds = " + project_prefix + "last_section_statistics.load_seconds;\n";
+		output += "}\n";
+	}
+
 	for(auto& rt : parsed_file.load_save_routines) {
 		header_output += "DCON_LUADLL_API void " + project_prefix + rt.name + "_write_file(char const* name); \n";
 		output += "void " + project_prefix + rt.name + "_write_file(char const* name) { \n";
 		output += "\tstd::ofstream file_out(name, std::ios::binary);\n";
-		output += "\t"+ parsed_file.namspace + "::load_record selection = "+game_state+"make_serialize_record_" + rt.name + "();\n";
-		output += "\tauto sz = "+game_state+"serialize_size(selection);\n";
+		output += "\t"+ parsed_file.namspace + "::load_record selection = "+ctx.game_state+"make_serialize_record_" + rt.name + "();\n";
+		output += "\tauto sz = "+ctx.game_state+"serialize_size(selection);\n";
 		output += "\tstd::byte* temp_buffer = new std::byte[sz];\n";
 		output += "\tauto ptr = temp_buffer;\n";
-		output += "\t"+game_state+"serialize(ptr, selection); \n";
+		output += "\t"+ctx.game_state+"serialize(ptr, selection); \n";
 		output += "\tfile_out.write((char*)temp_buffer, sz);\n";
 		output += "\tdelete[] temp_buffer;\n";
 		output += "}\n";
 
 		header_output += "DCON_LUADLL_API void " + project_prefix + rt.name + "_read_file(char const* name); \n";
 		output += "void " + project_prefix + rt.name + "_read_file(char const* name) { \n";
+		output += rebuild_guard;
 		output += "\tstd::ifstream file_in(name, std::ios::binary);\n";
 		output += "\tfile_in.unsetf(std::ios::skipws);\n";
 		output += "\tfile_in.seekg(0, std::ios::end);\n";
@@ -1505,45 +3952,70 @@ int main(int argc, char *argv[]) {
 		output += "\tvec.insert(vec.begin(), std::istream_iterator<unsigned char>(file_in),  std::istream_iterator<unsigned char>());\n";
 		output += "\tstd::byte const* ptr = (std::byte const*)(vec.data());\n";
 		output += "\t" + parsed_file.namspace + "::load_record loaded;\n";
-		output += "\t" + parsed_file.namspace + "::load_record selection = "+game_state+"make_serialize_record_" + rt.name + "();\n";
-		output += "\t"+game_state+"deserialize(ptr, ptr + sz, loaded, selection); \n";
+		output += "\t" + parsed_file.namspace + "::load_record selection = "+ctx.game_state+"make_serialize_record_" + rt.name + "();\n";
+		output += "\t"+ctx.game_state+"deserialize(ptr, ptr + sz, loaded, selection); \n";
 		output += "}\n";
+
+		if(parsed_file.relationship_objects.size() > 0) {
+			// section indexed variant: objects are encoded and decoded in parallel
+			header_output += "DCON_LUADLL_API void " + project_prefix + rt.name + "_write_sectioned_file(char const* name); \n";
+			output += "void " + project_prefix + rt.name + "_write_sectioned_file(char const* name) { \n";
+			output += "\t" + project_prefix + "save_sections(name, "+ctx.game_state+"make_serialize_record_" + rt.name + "(), false);\n";
+			output += "}\n";
+
+			header_output += "DCON_LUADLL_API void " + project_prefix + rt.name + "_write_compressed_file(char const* name); \n";
+			output += "void " + project_prefix + rt.name + "_write_compressed_file(char const* name) { \n";
+			output += "\t" + project_prefix + "save_sections(name, "+ctx.game_state+"make_serialize_record_" + rt.name + "(), true);\n";
+			output += "}\n";
+
+			header_output += "DCON_LUADLL_API bool " + project_prefix + rt.name + "_read_sectioned_file(char const* name); \n";
+			output += "bool " + project_prefix + rt.name + "_read_sectioned_file(char const* name) { \n";
+			output += rebuild_guard;
+			output += "\treturn " + project_prefix + "load_sections(name, "+ctx.game_state+"make_serialize_record_" + rt.name + "(), nullptr);\n";
+			output += "}\n";
+
+			header_output += "DCON_LUADLL_API bool " + project_prefix + rt.name + "_read_sections(char const* name, uint8_t const* mask); \n";
+			output += "bool " + project_prefix + rt.name + "_read_sections(char const* name, uint8_t const* mask) { \n";
+			output += rebuild_guard;
+			output += "\treturn " + project_prefix + "load_sections(name, "+ctx.game_state+"make_serialize_record_" + rt.name + "(), mask);\n";
+			output += "}\n";
+		}
 	}
 
+	auto lua_globals = make_globals(ctx, parsed_file, project_prefix, output, header_output);
+
+	make_replication_snapshots(ctx, parsed_file, project_prefix, output, header_output);
+	make_replication_deltas(ctx, parsed_file, project_prefix, output, header_output);
+
 	header_output += "}\n"; // close extern C
 
 	//newline at end of file
 	output += "\n";
 
-	{
-		std::fstream fileout;
-		fileout.open(dll_source_name, std::ios::out);
-		if(fileout.is_open()) {
-			fileout << output;
-			fileout.close();
-		} else {
-			std::abort();
-		}
-	}
-	{
-		std::fstream fileout;
-		fileout.open(dll_header_name, std::ios::out);
-		if(fileout.is_open()) {
-			fileout << header_output;
-			fileout.close();
-		} else {
-			std::abort();
+	result.files.push_back(generated_file{ dll_source_name, output });
+	if(split_objects) {
+		result.files.push_back(generated_file{ shared_header_name, shared_header });
+		// comment lines are skipped with file(STRINGS <list> <var> REGEX "^[^#]") in cmake
+		std::string source_list;
+		source_list += "# generated from " + options.definition_name + "; every unit compiles on its own and uses\n";
+		source_list += "# the container declared as \"" + container_variable + "\" in " + shared_include_name + ", which one of your own sources must define\n";
+		source_list += dll_source_name + "\n";
+		for(size_t i = 0; i < object_sources.size(); ++i) {
+			auto const object_source_name = dll_source_stem + "_" + parsed_file.relationship_objects[i].name + ".cpp";
+			source_list += object_source_name + "\n";
+			result.files.push_back(generated_file{ object_source_name, object_sources[i] });
 		}
+		result.files.push_back(generated_file{ dll_source_stem + "_sources.txt", source_list });
 	}
+	result.files.push_back(generated_file{ dll_header_name, header_output });
 
-	{
-		std::fstream fileout;
-		fileout.open(lua_folder + "/_ids.lua", std::ios::out);
-		if(fileout.is_open()) {
-			fileout << lua_ids_collection;
-			fileout.close();
-		} else {
-			std::abort();
-		}
-	}
+	for(size_t i = 0; i < object_outputs.size(); ++i)
+		result.files.push_back(generated_file{ lua_folder + "/" + parsed_file.relationship_objects[i].name + ".lua", object_outputs[i].lua });
+	result.files.push_back(generated_file{ lua_folder + "/_ids.lua", lua_ids_collection });
+	if(has_events(parsed_file))
+		result.files.push_back(generated_file{ lua_folder + "/_events.lua", make_events_lua(parsed_file, project_prefix) });
+	if(lua_globals.length() > 0)
+		result.files.push_back(generated_file{ lua_folder + "/_globals.lua", lua_globals });
+
+	return result;
 }
@@ -0,0 +1,35 @@
+#pragma once
+
+//
+// Lua FFI binding generator as a library: turns the text of a DataContainer definition file into the
+// generated c++ source, header and Lua files, all held in memory. Each call has its own context,
+// so several schemas may be generated at once from different threads.
+//
+
+#include <string>
+#include <vector>
+
+struct generation_options {
+	std::string project_name;             // prefix of every exported function
+	std::string data_container;           // expression the generated code accesses the container through, e.g. "state."
+	std::string definition_name;          // used in error messages and in the banner of the generated files
+	std::string source_name;
+	std::string header_name;
+	std::string lua_folder;
+	bool split_objects = false;           // one extra translation unit per object, listed in <source stem>_sources.txt
+	std::string container_header;         // declares the container type, as written in #include; required by split_objects
+};
+
+struct generated_file {
+	std::string name;
+	std::string contents;
+};
+
+struct generation_result {
+	std::vector<generated_file> files;
+	std::string errors;                   // not empty when generation failed, in which case there are no files
+};
+
+generation_result generate_bindings(generation_options const& options, std::string const& definition);
+// the definition text is only read during the call and may be a view into a mapped file
+generation_result generate_bindings(generation_options const& options, char const* definition_start, char const* definition_end);
@@ -0,0 +1,298 @@
+//
+// command line front end of the generator: reads the definition file, skips work when the outputs are
+// up to date and writes whatever generate_bindings produced
+//
+
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <cerrno>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define DCON_LUA_MMAP 1
+#endif
+
+#include "parsing.hpp"
+#include "LuaFFIGenerator.hpp"
+
+// set by cmake from git describe; builds outside of a checkout share one version, so their stamps
+// survive generator upgrades and the outputs have to be removed by hand
+#ifndef DCON_LUA_GENERATOR_VERSION
+#define DCON_LUA_GENERATOR_VERSION "unversioned"
+#endif
+
+void error_to_file(std::string const& file_name) {
+	std::fstream fileout;
+	fileout.open(file_name, std::ios::out);
+	if(fileout.is_open()) {
+		fileout << "";
+		fileout.close();
+	}
+}
+
+// leaves the file (and its timestamp) alone when it already holds these contents; reports the file
+// and returns false when it cannot be written
+bool write_if_changed(std::string const& file_name, std::string const& contents) {
+	{
+		std::fstream existing;
+		existing.open(file_name, std::ios::in);
+		if(existing.is_open()) {
+			std::string old_contents((std::istreambuf_iterator<char>(existing)), std::istreambuf_iterator<char>());
+			if(old_contents == contents)
+				return true;
+		}
+	}
+	std::fstream fileout;
+	fileout.open(file_name, std::ios::out);
+	if(fileout.is_open()) {
+		fileout << contents;
+		fileout.close();
+	}
+	if(!fileout) {
+		std::cout << "could not write " << file_name << ": " << std::strerror(errno) << "\n";
+		return false;
+	}
+	return true;
+}
+
+std::string read_whole_file(std::string const& file_name, std::ios::openmode mode = std::ios::in) {
+	std::fstream file_in;
+	file_in.open(file_name, mode);
+	if(!file_in.is_open())
+		return std::string();
+	return std::string((std::istreambuf_iterator<char>(file_in)), std::istreambuf_iterator<char>());
+}
+
+// read-only view of a whole file: mapped into memory where the platform allows it, read into a string otherwise.
+// A mapping faults when the file is truncated under it, so callers that expect the file to be rewritten
+// while they read it (the watch loop) ask for a copy instead
+class mapped_file {
+	std::string fallback;
+	char const* data = nullptr;
+	size_t size = 0;
+	bool mapped = false;
+	bool opened = false;
+public:
+	mapped_file(std::string const& file_name, std::ios::openmode fallback_mode = std::ios::in, bool allow_mapping = true) {
+#ifdef DCON_LUA_MMAP
+		int fd = allow_mapping ? open(file_name.c_str(), O_RDONLY | O_CLOEXEC) : -1;
+		if(fd >= 0) {
+			struct stat info;
+			bool const regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+			if(regular && info.st_size > 0) {
+				void* ptr = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				if(ptr != MAP_FAILED) {
+					data = static_cast<char const*>(ptr);
+					size = size_t(info.st_size);
+					mapped = true;
+				}
+			}
+			close(fd);
+			// directories and the like are not definitions; empty files need no mapping
+			if(!regular || mapped || info.st_size == 0) {
+				opened = regular;
+				return;
+			}
+		}
+#endif
+		std::fstream file_in;
+		file_in.open(file_name, fallback_mode);
+		if(file_in.is_open()) {
+			opened = true;
+			fallback.assign((std::istreambuf_iterator<char>(file_in)), std::istreambuf_iterator<char>());
+			data = fallback.data();
+			size = fallback.size();
+		}
+	}
+	~mapped_file() {
+#ifdef DCON_LUA_MMAP
+		if(mapped)
+			munmap(const_cast<char*>(data), size);
+#endif
+	}
+	mapped_file(mapped_file const&) = delete;
+	mapped_file& operator=(mapped_file const&) = delete;
+
+	bool is_open() const {
+		return opened;
+	}
+	std::string_view contents() const {
+		return size > 0 ? std::string_view(data, size) : std::string_view();
+	}
+};
+
+// hash of the generator version, the definition file and the arguments that shape the outputs
+std::string make_stamp(std::string_view definition, int argc, char* argv[]) {
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&](std::string_view s) {
+		for(auto c : s) {
+			hash ^= uint8_t(c);
+			hash *= 1099511628211ull;
+		}
+		// separator, so that moving text between arguments changes the hash
+		hash ^= 0xFF;
+		hash *= 1099511628211ull;
+	};
+	mix(DCON_LUA_GENERATOR_VERSION);
+	mix(definition);
+	for(int i = 1; i < argc; ++i) {
+		if(std::string_view(argv[i]) != "--watch")
+			mix(argv[i]);
+	}
+
+	char text[17];
+	std::snprintf(text, sizeof(text), "%016llx", (unsigned long long)hash);
+	return std::string(text) + "\n";
+}
+
+// the stamp file holds the hash on its first line followed by the name of every output made with it,
+// and only vouches for those outputs while all of them are still there
+bool stamp_matches(std::string const& stamp_name, std::string const& stamp) {
+	auto const recorded = read_whole_file(stamp_name);
+	if(recorded.compare(0, stamp.length(), stamp) != 0)
+		return false;
+	size_t outputs = 0;
+	for(size_t start = stamp.length(); start < recorded.length(); ) {
+		auto const end = recorded.find('\n', start);
+		if(end == std::string::npos || !std::filesystem::exists(recorded.substr(start, end - start)))
+			return false;
+		++outputs;
+		start = end + 1;
+	}
+	return outputs > 0;
+}
+
+// reads the definition and brings the outputs up to date with it
+int run(generation_options const& options, int argc, char* argv[], bool map_definition) {
+	mapped_file const input_file(options.definition_name, std::ios::in, map_definition);
+	if(!input_file.is_open()) {
+		error_record err(options.definition_name);
+		err.add(row_col_pair{ 0, 0}, 1000, "Could not open input file");
+		std::cout << err.accumulated;
+		return -1;
+	}
+	auto const file_contents = input_file.contents();
+
+	// a matching stamp means the existing outputs were made from this same input by this same generator
+	auto const stamp_name = options.source_name + ".stamp";
+	auto const stamp = make_stamp(file_contents, argc, argv);
+	if(stamp_matches(stamp_name, stamp))
+		return 0;
+	{
+		std::error_code ec;
+		std::filesystem::remove(stamp_name, ec);
+	}
+
+	auto const result = generate_bindings(options, file_contents.data(), file_contents.data() + file_contents.length());
+	if(result.errors.length() > 0) {
+		error_to_file(options.header_name);
+		std::cout << result.errors;
+		return -1;
+	}
+
+	// a folder that cannot be made shows up as the files that cannot be written into it
+	std::error_code ec;
+	std::filesystem::create_directory(options.lua_folder, ec);
+	auto stamp_contents = stamp;
+	bool written = true;
+	for(auto& f : result.files) {
+		written = write_if_changed(f.name, f.contents) && written;
+		stamp_contents += f.name + "\n";
+	}
+
+	// without all of its outputs the stamp is left out, so that the next run writes them again
+	if(!written)
+		return -1;
+	if(!write_if_changed(stamp_name, stamp_contents))
+		return -1;
+	return 0;
+}
+
+#ifdef __linux__
+// reruns the generator whenever the definition file is saved; the folder is watched rather than the file
+// because editors commonly save by writing a new file and renaming it over the old one
+void watch(generation_options const& options, int argc, char* argv[]) {
+	auto const definition_path = std::filesystem::path(options.definition_name);
+	auto const folder = definition_path.has_parent_path() ? definition_path.parent_path().string() : std::string(".");
+	auto const file_name = definition_path.filename().string();
+
+	int fd = inotify_init1(IN_CLOEXEC);
+	if(fd < 0 || inotify_add_watch(fd, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		std::cout << "could not watch " << folder << ": " << std::strerror(errno) << "\n";
+		if(fd >= 0)
+			close(fd);
+		return;
+	}
+
+	alignas(inotify_event) char buffer[4096];
+	while(true) {
+		auto length = read(fd, buffer, sizeof(buffer));
+		if(length < 0 && errno == EINTR)
+			continue;
+		if(length <= 0)
+			break;
+
+		bool definition_changed = false;
+		for(char* ptr = buffer; ptr < buffer + length; ) {
+			auto const event = reinterpret_cast<inotify_event const*>(ptr);
+			if(event->len > 0 && file_name == event->name)
+				definition_changed = true;
+			ptr += sizeof(inotify_event) + event->len;
+		}
+
+		// unchanged contents are caught by the stamp, unchanged outputs by write_if_changed
+		if(definition_changed && run(options, argc, argv, false) == 0)
+			std::cout << options.definition_name << ": outputs up to date\n";
+		std::cout.flush();
+	}
+	close(fd);
+}
+#endif
+
+int main(int argc, char *argv[]) {
+	if (argc < 7) {
+		printf("[1]: PROJECT NAME, [2] DATA CONTAINER VARIABLE, [3]: DCON DEFINITION FILE, [4]: CPP OUTPUT FILE, [5]: HPP OUTPUT FILE, [6]: LUA OUTPUT FOLDER, [7...] (OPTIONAL): --split-objects, --container-header <file>, --watch");
+		return 1;
+	}
+
+	generation_options options;
+	options.project_name = argv[1];
+	options.data_container = argv[2];
+	options.definition_name = argv[3];
+	options.source_name = argv[4];
+	options.header_name = argv[5];
+	options.lua_folder = argv[6];
+	bool watch_definition = false;
+	for(int i = 7; i < argc; ++i) {
+		if(std::string(argv[i]) == "--split-objects")
+			options.split_objects = true;
+		else if(std::string(argv[i]) == "--container-header" && i + 1 < argc)
+			options.container_header = argv[++i];
+		else if(std::string(argv[i]) == "--watch")
+			watch_definition = true;
+	}
+
+	auto const result = run(options, argc, argv, !watch_definition);
+	if(!watch_definition)
+		return result;
+
+#ifdef __linux__
+	std::cout.flush();
+	watch(options, argc, argv);
+#else
+	std::cout << "--watch is only supported on linux\n";
+#endif
+	return result;
+}
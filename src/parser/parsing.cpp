@@ -368,11 +368,51 @@ selection_item parse_selection_item(char const*& start, char const* end, char co
 	return result;
 }
 
+// offsets at which each line of the file being parsed starts; built on the first diagnostic so that every
+// lookup is a binary search instead of a scan from the start of the file
+struct line_index {
+	char const* start = nullptr;
+	char const* end = nullptr;
+	std::vector<int32_t> line_starts;
+};
+
+thread_local line_index* current_line_index = nullptr;
+
+struct line_index_scope {
+	line_index index;
+	line_index* previous;
+
+	line_index_scope(char const* start, char const* end) : previous(current_line_index) {
+		index.start = start;
+		index.end = end;
+		current_line_index = &index;
+	}
+	~line_index_scope() {
+		current_line_index = previous;
+	}
+};
+
 row_col_pair calculate_line_from_position(char const* start, char const* pos) {
 	row_col_pair result;
 	result.row = 1;
 	result.column = 1;
 
+	if(current_line_index && current_line_index->start == start && start <= pos && pos <= current_line_index->end) {
+		auto& lines = current_line_index->line_starts;
+		if(lines.empty()) {
+			lines.push_back(0);
+			for(char const* t = start; t < current_line_index->end; ++t) {
+				if(*t == '\n')
+					lines.push_back(int32_t(t - start) + 1);
+			}
+		}
+		auto const offset = int32_t(pos - start);
+		auto const line = std::upper_bound(lines.begin(), lines.end(), offset) - 1;
+		result.row = int32_t(line - lines.begin()) + 1;
+		result.column = offset - *line + 1;
+		return result;
+	}
+
 	char const* t = start;
 	while(t < pos) {
 		if(*t == '\n') {
@@ -419,7 +459,7 @@ load_save_def parse_load_save_def(char const* start, char const* end, char const
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 3,
@@ -477,7 +517,7 @@ load_save_def parse_load_save_def(char const* start, char const* end, char const
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 10,
-					std::string("unexpected token \"") + kstr + "\" while parsing loading/saving routine defintion");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing loading/saving routine defintion");
 			}
 		}
 	}
@@ -493,7 +533,7 @@ related_object parse_link_def(char const* start, char const* end, char const* gl
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 11,
@@ -505,30 +545,30 @@ related_object parse_link_def(char const* start, char const* end, char const* gl
 				if(extracted.values.size() == 0 || extracted.values.size() > 2) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 12,
 						std::string("wrong number of parameters for \"type\""));
-				} else if(extracted.values[0].to_string() == "unique") {
+				} else if(extracted.values[0].view() == "unique") {
 					result.index = index_type::at_most_one;
 					if(extracted.values.size() > 1) {
-						if(extracted.values[1].to_string() == "optional") {
+						if(extracted.values[1].view() == "optional") {
 							result.is_optional = true;
 						} else {
 							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 13,
 								std::string("unknown parameter \"") + extracted.values[1].to_string() + "\" passed to type");
 						}
 					}
-				} else if(extracted.values[0].to_string() == "many") {
+				} else if(extracted.values[0].view() == "many") {
 					result.index = index_type::many;
 					if(extracted.values.size() > 1) {
-						if(extracted.values[1].to_string() == "optional") {
+						if(extracted.values[1].view() == "optional") {
 							result.is_optional = true;
 						} else {
 							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 13,
 								std::string("unknown parameter \"") + extracted.values[1].to_string() + "\" passed to type");
 						}
 					}
-				} else if(extracted.values[0].to_string() == "unindexed") {
+				} else if(extracted.values[0].view() == "unindexed") {
 					result.index = index_type::none;
 					if(extracted.values.size() > 1) {
-						if(extracted.values[1].to_string() == "optional") {
+						if(extracted.values[1].view() == "optional") {
 							result.is_optional = true;
 						} else {
 							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 13,
@@ -550,11 +590,11 @@ related_object parse_link_def(char const* start, char const* end, char const* gl
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 16,
 						std::string("wrong number of parameters for \"index_storage\""));
-				} else if(extracted.values[0].to_string() == "std_vector") {
+				} else if(extracted.values[0].view() == "std_vector") {
 					result.ltype = list_type::std_vector;
-				} else if(extracted.values[0].to_string() == "list") {
+				} else if(extracted.values[0].view() == "list") {
 					result.ltype = list_type::list;
-				} else if(extracted.values[0].to_string() == "array") {
+				} else if(extracted.values[0].view() == "array") {
 					result.ltype = list_type::array;
 				} else {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 17,
@@ -567,7 +607,7 @@ related_object parse_link_def(char const* start, char const* end, char const* gl
 				} else {
 					result.multiplicity = std::stoi(extracted.values[0].to_string());
 					if(extracted.values.size() == 2) {
-						if(extracted.values[1].to_string() == "distinct") {
+						if(extracted.values[1].view() == "distinct") {
 							result.is_distinct = true;
 						} else {
 							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 18,
@@ -597,7 +637,7 @@ related_object parse_link_def(char const* start, char const* end, char const* gl
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 22,
-					std::string("unexpected token \"") + kstr + "\" while parsing link defintion");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing link defintion");
 			}
 		}
 	}
@@ -613,7 +653,7 @@ composite_index_def parse_composite_key(char const* start, char const* end, char
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 23,
@@ -630,7 +670,7 @@ composite_index_def parse_composite_key(char const* start, char const* end, char
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 25,
-					std::string("unexpected token \"") + kstr + "\" while parsing composite key");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing composite key");
 			}
 		}
 	}
@@ -646,7 +686,7 @@ property_def parse_property_def(char const* start, char const* end, char const*
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 26,
@@ -660,7 +700,7 @@ property_def parse_property_def(char const* start, char const* end, char const*
 						std::string("wrong number of parameters for \"type\""));
 				} else {
 					auto inner_extracted = extract_item(extracted.values[0].start, extracted.values[0].end, global_start, err_out);
-					std::string ikstr = inner_extracted.key.to_string();
+					std::string_view const ikstr = inner_extracted.key.view();
 
 					if(ikstr == "bitfield") {
 						result.type = property_type::bitfield;
@@ -678,7 +718,7 @@ property_def parse_property_def(char const* start, char const* end, char const*
 								std::string("wrong number of parameters for \"derived\""));
 						} else {
 							result.is_derived = true;
-							if(inner_extracted.values[0].to_string() == "bitfield")
+							if(inner_extracted.values[0].view() == "bitfield")
 								result.type = property_type::bitfield;
 							else
 								result.type = property_type::other;
@@ -699,7 +739,7 @@ property_def parse_property_def(char const* start, char const* end, char const*
 								std::string("wrong number of parameters for \"array\""));
 						} else if(inner_extracted.values.size() == 2) {
 							result.array_index_type = inner_extracted.values[0].to_string();
-							if(inner_extracted.values[1].to_string() == "bitfield") {
+							if(inner_extracted.values[1].view() == "bitfield") {
 								result.type = property_type::array_bitfield;
 							} else {
 								result.type = property_type::array_other;
@@ -707,7 +747,7 @@ property_def parse_property_def(char const* start, char const* end, char const*
 							}
 						} else {
 							result.array_index_type = "uint32_t";
-							if(inner_extracted.values[0].to_string() == "bitfield") {
+							if(inner_extracted.values[0].view() == "bitfield") {
 								result.type = property_type::array_bitfield;
 							} else {
 								result.type = property_type::array_other;
@@ -717,7 +757,7 @@ property_def parse_property_def(char const* start, char const* end, char const*
 					} else {
 						if(inner_extracted.values.size() != 0) {
 							err_out.add(calculate_line_from_position(global_start, extracted.key.start), 32,
-								std::string("unexpected key \"") + ikstr + "\"");
+								std::string("unexpected key \"") + std::string(ikstr) + "\"");
 						} else {
 							result.type = property_type::other;
 							result.data_type = inner_extracted.key.to_string();
@@ -728,9 +768,9 @@ property_def parse_property_def(char const* start, char const* end, char const*
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 33,
 						std::string("wrong number of parameters for \"hook\""));
-				} else if(extracted.values[0].to_string() == "get") {
+				} else if(extracted.values[0].view() == "get") {
 					result.hook_get = true;
-				} else if(extracted.values[0].to_string() == "set") {
+				} else if(extracted.values[0].view() == "set") {
 					result.hook_set = true;
 				} else {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 34,
@@ -765,7 +805,7 @@ property_def parse_property_def(char const* start, char const* end, char const*
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 40,
-					std::string("unexpected token \"") + kstr + "\" while parsing property defintion");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing property defintion");
 			}
 		}
 	}
@@ -783,7 +823,7 @@ relationship_object_def parse_relationship(char const* start, char const* end, c
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 41,
@@ -803,15 +843,15 @@ relationship_object_def parse_relationship(char const* start, char const* end, c
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 43,
 						std::string("wrong number of parameters for \"storage_type\""));
 				} else {
-					if(extracted.values[0].to_string() == "contiguous") {
+					if(extracted.values[0].view() == "contiguous") {
 						result.store_type = storage_type::contiguous;
-					} else if(extracted.values[0].to_string() == "erasable") {
+					} else if(extracted.values[0].view() == "erasable") {
 						result.store_type = storage_type::erasable;
-					} else if(extracted.values[0].to_string() == "compactable") {
+					} else if(extracted.values[0].view() == "compactable") {
 						result.store_type = storage_type::compactable;
 					} else {
 						err_out.add(calculate_line_from_position(global_start, extracted.key.start), 44,
-							std::string("unknown parameter \"") + kstr + "\" passed to storage_type");
+							std::string("unknown parameter \"") + std::string(kstr) + "\" passed to storage_type");
 					}
 				}
 			} else if(kstr == "size") {
@@ -819,7 +859,7 @@ relationship_object_def parse_relationship(char const* start, char const* end, c
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 45,
 						std::string("wrong number of parameters for \"size\""));
 				} else {
-					if(extracted.values[0].to_string() == "expandable") {
+					if(extracted.values[0].view() == "expandable") {
 						result.is_expandable = true;
 						result.size = 0;
 					} else {
@@ -911,11 +951,11 @@ relationship_object_def parse_relationship(char const* start, char const* end, c
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 52,
 						std::string("wrong number of parameters for \"hook\""));
-				} else if(extracted.values[0].to_string() == "create") {
+				} else if(extracted.values[0].view() == "create") {
 					result.hook_create = true;
-				} else if(extracted.values[0].to_string() == "delete") {
+				} else if(extracted.values[0].view() == "delete") {
 					result.hook_delete = true;
-				} else if(extracted.values[0].to_string() == "move") {
+				} else if(extracted.values[0].view() == "move") {
 					result.hook_move = true;
 				} else {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 53,
@@ -923,7 +963,7 @@ relationship_object_def parse_relationship(char const* start, char const* end, c
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 54,
-					std::string("unexpected token \"") + kstr + "\" while parsing relationship defintion");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing relationship defintion");
 			}
 		}
 	}
@@ -941,7 +981,7 @@ relationship_object_def parse_object(char const* start, char const* end, char co
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 55,
@@ -954,15 +994,15 @@ relationship_object_def parse_object(char const* start, char const* end, char co
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 56,
 						std::string("wrong number of parameters for \"storage_type\""));
 				} else {
-					if(extracted.values[0].to_string() == "contiguous") {
+					if(extracted.values[0].view() == "contiguous") {
 						result.store_type = storage_type::contiguous;
-					} else if(extracted.values[0].to_string() == "erasable") {
+					} else if(extracted.values[0].view() == "erasable") {
 						result.store_type = storage_type::erasable;
-					} else if(extracted.values[0].to_string() == "compactable") {
+					} else if(extracted.values[0].view() == "compactable") {
 						result.store_type = storage_type::compactable;
 					} else {
 						err_out.add(calculate_line_from_position(global_start, extracted.key.start), 57,
-							std::string("unknown parameter \"") + kstr + "\" passed to storage_type");
+							std::string("unknown parameter \"") + std::string(kstr) + "\" passed to storage_type");
 					}
 				}
 			} else if(kstr == "size") {
@@ -970,7 +1010,7 @@ relationship_object_def parse_object(char const* start, char const* end, char co
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 58,
 						std::string("wrong number of parameters for \"size\""));
 				} else {
-					if(extracted.values[0].to_string() == "expandable") {
+					if(extracted.values[0].view() == "expandable") {
 						result.is_expandable = true;
 						result.size = 0;
 					} else {
@@ -989,11 +1029,11 @@ relationship_object_def parse_object(char const* start, char const* end, char co
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 60,
 						std::string("wrong number of parameters for \"hook\""));
-				} else if(extracted.values[0].to_string() == "create") {
+				} else if(extracted.values[0].view() == "create") {
 					result.hook_create = true;
-				} else if(extracted.values[0].to_string() == "delete") {
+				} else if(extracted.values[0].view() == "delete") {
 					result.hook_delete = true;
-				} else if(extracted.values[0].to_string() == "move") {
+				} else if(extracted.values[0].view() == "move") {
 					result.hook_move = true;
 				} else {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 61,
@@ -1058,7 +1098,7 @@ relationship_object_def parse_object(char const* start, char const* end, char co
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 65,
-					std::string("unexpected token \"") + kstr + "\" while parsing relationship defintion");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing relationship defintion");
 			}
 		}
 	}
@@ -1074,7 +1114,7 @@ std::vector<std::string> parse_legacy_types(char const* start, char const* end,
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 66,
@@ -1084,7 +1124,7 @@ std::vector<std::string> parse_legacy_types(char const* start, char const* end,
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 67,
-					std::string("unexpected token \"") + kstr + "\" while parsing legacy types list");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing legacy types list");
 			}
 		}
 	}
@@ -1099,7 +1139,7 @@ conversion_def parse_conversion_def(char const* start, char const* end, char con
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "from") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 68,
@@ -1122,7 +1162,7 @@ conversion_def parse_conversion_def(char const* start, char const* end, char con
 				}
 			} else {
 				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 72,
-					std::string("unexpected token \"") + kstr + "\" while parsing conversion defintion");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing conversion defintion");
 			}
 		}
 	}
@@ -1138,7 +1178,7 @@ std::vector<type_name_pair> parse_query_parameters_list(char const*& start, char
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 
 			if(extracted.values.size() == 0) {
 				err.add(calculate_line_from_position(global_start, extracted.key.start), 73,
@@ -1147,7 +1187,7 @@ std::vector<type_name_pair> parse_query_parameters_list(char const*& start, char
 				err.add(calculate_line_from_position(global_start, extracted.key.start), 74,
 					std::string("too many type declarations"));
 			} else {
-				result.push_back(type_name_pair{ kstr, extracted.values[0].to_string() });
+				result.push_back(type_name_pair{ std::string(kstr), extracted.values[0].to_string() });
 			}
 		}
 	}
@@ -1163,7 +1203,7 @@ query_definition parse_query_definition(char const*& start, char const* end, cha
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr = extracted.key.to_string();
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "name") {
 				if(extracted.values.size() != 1) {
 					err.add(calculate_line_from_position(global_start, extracted.key.start), 75,
@@ -1191,14 +1231,87 @@ query_definition parse_query_definition(char const*& start, char const* end, cha
 				}
 			} else {
 				err.add(calculate_line_from_position(global_start, extracted.key.start), 79,
-					std::string("unexpected token \"") + kstr + "\" while parsing query defintion");
+					std::string("unexpected token \"") + std::string(kstr) + "\" while parsing query defintion");
+			}
+		}
+	}
+	return result;
+}
+
+kernel_def parse_kernel_def(char const* start, char const* end, char const* global_start, error_record& err_out) {
+	kernel_def result;
+	result.position = int32_t(start - global_start);
+	char const* pos = start;
+	while(pos < end) {
+		auto extracted = extract_item(pos, end, global_start, err_out);
+		pos = extracted.terminal;
+
+		if(extracted.key.start != extracted.key.end) {
+			std::string_view const kstr = extracted.key.view();
+			if(kstr == "name") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 110,
+						std::string("wrong number of parameters for \"name\""));
+				} else {
+					result.name = extracted.values[0].to_string();
+				}
+			} else if(kstr == "object") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 111,
+						std::string("wrong number of parameters for \"object\""));
+				} else {
+					result.object = extracted.values[0].to_string();
+				}
+			} else if(kstr == "parameter") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 112,
+						std::string("wrong number of parameters for \"parameter\""));
+				} else {
+					auto name_end = reverse_to_non_whitespace(extracted.values[0].start, extracted.values[0].end);
+					auto name_start = name_end;
+					while(name_start > extracted.values[0].start && *(name_start - 1) != ' ' && *(name_start - 1) != '\t'
+						&& *(name_start - 1) != '\n' && *(name_start - 1) != '\r') {
+						--name_start;
+					}
+					auto type_end = reverse_to_non_whitespace(extracted.values[0].start, name_start);
+					if(type_end == extracted.values[0].start || name_start == name_end) {
+						err_out.add(calculate_line_from_position(global_start, extracted.key.start), 106,
+							std::string("a kernel parameter must be a type followed by a name"));
+					} else {
+						result.parameter_types.push_back(std::string(extracted.values[0].start, type_end));
+						result.parameter_names.push_back(std::string(name_start, name_end));
+					}
+				}
+			} else if(kstr == "body") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(global_start, extracted.key.start), 113,
+						std::string("wrong number of parameters for \"body\""));
+				} else {
+					char const* statement_start = extracted.values[0].start;
+					for(char const* p = statement_start; p <= extracted.values[0].end; ++p) {
+						if(p == extracted.values[0].end || *p == ';') {
+							auto first = advance_to_non_whitespace(statement_start, p);
+							auto last = reverse_to_non_whitespace(first, p);
+							if(first < last)
+								result.statements.push_back(std::string(first, last));
+							statement_start = p + 1;
+						}
+					}
+				}
+			} else {
+				err_out.add(calculate_line_from_position(global_start, extracted.key.start), 107,
+					std::string("unexpected kernel key: ") + std::string(kstr));
 			}
 		}
 	}
+	if(result.name.empty() || result.object.empty()) {
+		err_out.add(calculate_line_from_position(global_start, start), 108, std::string("a kernel requires a name and an object"));
+	}
 	return result;
 }
 
 file_def parse_file(char const* start, char const* end, error_record& err_out) {
+	line_index_scope const lines(start, end);
 	file_def parsed_file;
 
 	char const* pos = start;
@@ -1207,7 +1320,7 @@ file_def parse_file(char const* start, char const* end, error_record& err_out) {
 		pos = extracted.terminal;
 
 		if(extracted.key.start != extracted.key.end) {
-			std::string kstr(extracted.key.start, extracted.key.end);
+			std::string_view const kstr = extracted.key.view();
 			if(kstr == "namespace") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(start, extracted.key.start), 80,
@@ -1262,6 +1375,14 @@ file_def parse_file(char const* start, char const* end, error_record& err_out) {
 					parsed_file.load_save_routines.push_back(
 						parse_load_save_def(extracted.values[0].start, extracted.values[0].end, start, err_out));
 				}
+			} else if(kstr == "kernel") {
+				if(extracted.values.size() != 1) {
+					err_out.add(calculate_line_from_position(start, extracted.key.start), 109,
+						std::string("wrong number of parameters for \"kernel\""));
+				} else {
+					parsed_file.kernels.push_back(
+						parse_kernel_def(extracted.values[0].start, extracted.values[0].end, start, err_out));
+				}
 			} else if(kstr == "object") {
 				if(extracted.values.size() != 1) {
 					err_out.add(calculate_line_from_position(start, extracted.key.start), 87,
@@ -1288,11 +1409,14 @@ file_def parse_file(char const* start, char const* end, error_record& err_out) {
 				}
 			} else {
 				err_out.add(calculate_line_from_position(start, extracted.key.start), 90,
-					std::string("unexpetected top level key: ") + kstr);
+					std::string("unexpetected top level key: ") + std::string(kstr));
 			}
 		}
 	}
 
+	for(size_t i = 0; i < parsed_file.relationship_objects.size(); ++i)
+		parsed_file.object_positions.emplace(parsed_file.relationship_objects[i].name, i);
+
 	return parsed_file;
 }
 
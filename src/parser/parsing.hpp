@@ -1,7 +1,9 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
 #include <algorithm>
 #include <cstring>
 #include <limits>
@@ -14,6 +16,9 @@ struct char_range {
 	std::string to_string() const {
 		return std::string(start, end);
 	}
+	std::string_view view() const {
+		return std::string_view(start, size_t(end - start));
+	}
 };
 
 struct parsed_item {
@@ -38,11 +43,14 @@ struct error_record {
 
 		accumulated += file_name;
 		if(rc.row > 0) {
+			// appended piece by piece: building the temporary trips a false -Wrestrict in gcc 12
+			accumulated += "(";
+			accumulated += std::to_string(rc.row);
 			if(rc.column > 0) {
-				accumulated += "(" + std::to_string(rc.row) + "," + std::to_string(rc.column) + ")";
-			} else {
-				accumulated += "(" + std::to_string(rc.row) + ")";
+				accumulated += ",";
+				accumulated += std::to_string(rc.column);
 			}
+			accumulated += ")";
 		} else {
 
 		}
@@ -188,6 +196,15 @@ struct load_save_def {
 	std::vector<std::string> property_tags;
 };
 
+struct kernel_def {
+	std::string name;
+	std::string object;
+	std::vector<std::string> parameter_types;
+	std::vector<std::string> parameter_names;
+	std::vector<std::string> statements;
+	int32_t position = 0; // offset of the definition in the file, only turned into a line when reported
+};
+
 struct conversion_def {
 	std::string from;
 	std::string to;
@@ -206,6 +223,7 @@ relationship_object_def parse_object(char const* start, char const* end, char co
 std::vector<std::string> parse_legacy_types(char const* start, char const* end, char const* global_start, error_record& err_out);
 conversion_def parse_conversion_def(char const* start, char const* end, char const* global_start, error_record& err_out);
 load_save_def parse_load_save_def(char const* start, char const* end, char const* global_start, error_record& err_out);
+kernel_def parse_kernel_def(char const* start, char const* end, char const* global_start, error_record& err_out);
 
 
 inline std::vector<std::string> common_types{ std::string("int8_t"), std::string("uint8_t"), std::string("int16_t"), std::string("uint16_t")
@@ -349,6 +367,14 @@ struct prepared_query_definition {
 	bool has_group = false;
 };
 
+// lets maps keyed by std::string be searched with a std::string_view
+struct name_hash {
+	using is_transparent = void;
+	size_t operator()(std::string_view s) const {
+		return std::hash<std::string_view>{}(s);
+	}
+};
+
 struct file_def {
 	std::string namspace = "dcon";
 	std::vector<std::string> includes;
@@ -357,7 +383,10 @@ struct file_def {
 	std::vector<made_id> extra_ids;
 
 	std::vector<relationship_object_def> relationship_objects;
+	// position of each object in relationship_objects by name, filled in at the end of parse_file
+	std::unordered_map<std::string, size_t, name_hash, std::equal_to<>> object_positions;
 	std::vector<load_save_def> load_save_routines;
+	std::vector<kernel_def> kernels;
 	std::vector<conversion_def> conversion_list;
 
 	std::vector<std::string> object_types;
@@ -370,7 +399,14 @@ prepared_query_definition make_prepared_definition(file_def const& parsed_file,
 
 file_def parse_file(char const* start, char const* end, error_record& err_out);
 
-inline relationship_object_def const* find_by_name(file_def const& def, std::string const& name) {
+inline relationship_object_def const* find_by_name(file_def const& def, std::string_view name) {
+	// the positions are only trusted while they still describe every object
+	if(def.object_positions.size() == def.relationship_objects.size()) {
+		if(auto it = def.object_positions.find(name); it != def.object_positions.end() && def.relationship_objects[it->second].name == name)
+			return &def.relationship_objects[it->second];
+		else if(it == def.object_positions.end())
+			return nullptr;
+	}
 	if(auto r = std::find_if(
 		def.relationship_objects.begin(), def.relationship_objects.end(),
 		[&name](relationship_object_def const& o) { return o.name == name; }); r != def.relationship_objects.end()) {
@@ -379,13 +415,8 @@ inline relationship_object_def const* find_by_name(file_def const& def, std::str
 	return nullptr;
 }
 
-inline relationship_object_def* find_by_name(file_def& def, std::string const& name) {
-	if(auto r = std::find_if(
-		def.relationship_objects.begin(), def.relationship_objects.end(),
-		[&name](relationship_object_def const& o) { return o.name == name; }); r != def.relationship_objects.end()) {
-		return &(*r);
-	}
-	return nullptr;
+inline relationship_object_def* find_by_name(file_def& def, std::string_view name) {
+	return const_cast<relationship_object_def*>(find_by_name(static_cast<file_def const&>(def), name));
 }
 
 inline std::string make_relationship_parameters(relationship_object_def const& o) {